@@ -0,0 +1,39 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define ARENA_DEFAULT_BLOCK_SIZE 1024   // 默认每块大小（字节）
+#define ARENA_ALIGNMENT sizeof(void *)  // 分配对齐
+
+// 竞技场内存块，按链表串联，只整体释放
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;   // 下一块
+    size_t capacity;           // 数据区容量
+    size_t used;               // 已使用字节数
+    unsigned char data[];      // 数据区
+} ArenaBlock;
+
+// 竞技场分配器：只追加分配，在内存预算内按需申请新块
+typedef struct Arena {
+    ArenaBlock *head;          // 当前块（链表头）
+    size_t block_size;         // 新块的默认容量
+    size_t budget;             // 内存预算（字节），0 表示不限制
+    size_t reserved;           // 已向系统申请的字节数（含块头和外部记账）
+    size_t used;               // 已分配给调用者的字节数
+
+    // 分配 size 字节，超出预算时返回 NULL
+    void *(*alloc)(struct Arena *self, size_t size);
+
+    // 为竞技场外的内存记账（delta 可为负），超出预算时返回 false
+    bool (*charge)(struct Arena *self, long delta);
+
+    // 释放全部内存块
+    void (*release)(struct Arena *self);
+} Arena;
+
+// 初始化竞技场分配器
+void arena_init(Arena *self, size_t block_size, size_t budget);
+
+#endif // ARENA_H
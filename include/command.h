@@ -1,48 +1,167 @@
 #ifndef COMMAND_H
 #define COMMAND_H
 
-#define MAX_COMMANDS 50
-#define MAX_ALIASES 20
-#define MAX_ARGC 10
-#define MAX_INPUT_SIZE 128
+#include <stddef.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "intern.h"
+#include "shell_config.h"
+
+#define COMMAND_ARENA_BLOCK_SIZE 512       // 注册表竞技场块大小（字节）
+#define REGISTRY_SEGMENT_BASE 8            // 首个表段的条目数，后续每段翻倍
+#define REGISTRY_MAX_SEGMENTS 16           // 表段数上限
+#define COMMAND_ARGS_MAX_SIZE 64           // 参数结构体的最大字节数（分发时在栈上解析）
+#define COMMAND_MAX_ARG_SPECS 16           // 单个参数模式的条目数上限
 
 // 错误码宏定义
 #define COMMAND_SUCCESS 0            // 操作成功
-#define COMMAND_ERROR_TABLE_FULL -1  // 命令表已满
-#define ALIAS_ERROR_TABLE_FULL -2    // 别名表已满
+#define COMMAND_ERROR_TABLE_FULL -1  // 命令表已满（超出内存预算）
+#define ALIAS_ERROR_TABLE_FULL -2    // 别名表已满（超出内存预算）
 #define COMMAND_ERROR_NO_INPUT -3    // 没有有效输入
 #define COMMAND_ERROR_NOT_FOUND -4   // 命令未找到
+#define COMMAND_ERROR_BUDGET -5      // 内存预算小于已使用量
+#define COMMAND_ERROR_INVALID_ARGS -6 // 参数不符合命令的参数模式（分发时已记录错误和用法）
+#define COMMAND_ERROR_BAD_SCHEMA -7  // 参数模式超出 COMMAND_ARGS_MAX_SIZE 或 COMMAND_MAX_ARG_SPECS
 
 typedef void (*CommandFunction)(int argc, char *argv[]);
 
+// 带参数模式的命令实现，args 指向按模式解析并校验过的参数结构体
+typedef void (*CommandHandler)(const void *args);
+
+// 参数类型及其在参数结构体中的字段类型
+typedef enum {
+    ARG_TYPE_FLAG,      // 开关，bool
+    ARG_TYPE_INT,       // 整数，int，校验 [min, max]
+    ARG_TYPE_CHOICE,    // 枚举，int，为候选值的下标
+    ARG_TYPE_STRING,    // 字符串，const char *，指向 argv，仅在命令执行期间有效
+    ARG_TYPE_REST       // 其余参数，CommandRest；只能是最后一个位置参数，之后的词原样保留（如 watch 的命令）
+} CommandArgType;
+
+// ARG_TYPE_REST 的结果：argv 中从第一个位置参数开始的其余部分
+typedef struct CommandRest {
+    int argc;                       // 词数
+    char **argv;                    // 指向原 argv，仅在命令执行期间有效
+} CommandRest;
+
+#define COMMAND_ARG_REQUIRED 0x1     // 必须给出
+
+// 参数模式中的一项：name 以 '-' 开头的是选项，后跟一个值（开关除外）；name 为 NULL 的是位置参数
+typedef struct CommandArg {
+    const char *name;               // 选项名，位置参数为 NULL
+    CommandArgType type;            // 参数类型
+    size_t offset;                  // 结果在参数结构体中的偏移
+    int flags;                      // COMMAND_ARG_REQUIRED
+    int min, max;                   // INT 的取值范围
+    int fallback;                   // INT/CHOICE 未给出时的值
+    const char *const *choices;     // CHOICE 的候选值，以 NULL 结束
+    const char *value_name;         // 用法文本中值的名字，NULL 时按类型生成
+} CommandArg;
+
+#define COMMAND_SCHEMA_ONE_OF 0x1    // 选项互斥且必须恰好给出一个，用法按 "a | b" 列出
+
+// 命令的参数模式
+typedef struct CommandSchema {
+    const CommandArg *args;         // 参数表
+    int arg_count;                  // 参数表条目数
+    size_t size;                    // 参数结构体大小
+    int flags;                      // COMMAND_SCHEMA_ONE_OF
+} CommandSchema;
+
+// 声明参数模式的辅助宏，例如：
+//   typedef struct { int level; bool stats; } LogArgs;
+//   static const CommandArg log_args[] = {
+//       COMMAND_ARG_INT("-level", LogArgs, level, 0, 2, -1),
+//       COMMAND_ARG_FLAG("-stats", LogArgs, stats),
+//   };
+//   static const CommandSchema log_schema = COMMAND_SCHEMA(log_args, LogArgs, COMMAND_SCHEMA_ONE_OF);
+#define COMMAND_ARG_FLAG(opt, record, field) \
+    { .name = (opt), .type = ARG_TYPE_FLAG, .offset = offsetof(record, field) }
+#define COMMAND_ARG_INT(opt, record, field, lo, hi, def) \
+    { .name = (opt), .type = ARG_TYPE_INT, .offset = offsetof(record, field), .min = (lo), .max = (hi), .fallback = (def) }
+#define COMMAND_ARG_CHOICE(opt, record, field, values, def) \
+    { .name = (opt), .type = ARG_TYPE_CHOICE, .offset = offsetof(record, field), .choices = (values), .fallback = (def) }
+#define COMMAND_ARG_STRING(opt, record, field, value) \
+    { .name = (opt), .type = ARG_TYPE_STRING, .offset = offsetof(record, field), .value_name = (value) }
+#define COMMAND_ARG_POSITIONAL(record, field, value) \
+    { .name = NULL, .type = ARG_TYPE_STRING, .offset = offsetof(record, field), .flags = COMMAND_ARG_REQUIRED, .value_name = (value) }
+#define COMMAND_ARG_REST(record, field, value) \
+    { .name = NULL, .type = ARG_TYPE_REST, .offset = offsetof(record, field), .flags = COMMAND_ARG_REQUIRED, .value_name = (value) }
+#define COMMAND_SCHEMA(table, record, schema_flags) \
+    { (table), (int)(sizeof(table) / sizeof((table)[0])), sizeof(record), (schema_flags) }
+
 // 定义命令结构体
 typedef struct Command {
-    char name[32];                  // 命令名称
-    CommandFunction function;       // 命令对应的执行函数
+    const char *name;               // 命令名称（驻留字符串）
+    CommandFunction function;       // 命令对应的执行函数，带参数模式的命令为 NULL
+    const CommandSchema *schema;    // 参数模式，NULL 表示命令自行解析 argv
+    CommandHandler handler;         // 带参数模式的命令实现
 } Command;
 
 // 定义别名结构体
 typedef struct AliasEntry {
-    char alias[MAX_INPUT_SIZE];       // 别名
-    char command_name[MAX_INPUT_SIZE]; // 对应的命令名称
+    const char *alias;              // 别名（驻留字符串）
+    const char *command_name;       // 对应的命令名称（驻留字符串）
 } AliasEntry;
 
+// 分段增长的注册表：第 k 段容纳 REGISTRY_SEGMENT_BASE << k 个条目，
+// 扩容时只追加新段，已有条目地址保持不变
+typedef struct RegistryTable {
+    void *segments[REGISTRY_MAX_SEGMENTS]; // 各段起始地址（分配在竞技场中）
+    size_t entry_size;                     // 单个条目大小
+    int segment_count;                     // 已分配段数
+    int capacity;                          // 总容量
+    int count;                             // 已使用条目数
+} RegistryTable;
+
+// 注册表内存使用统计
+typedef struct CommandMemoryStats {
+    size_t budget;           // 内存预算（字节），0 表示不限制
+    size_t reserved;         // 已申请字节数（竞技场块 + 哈希索引）
+    size_t used;             // 竞技场中已分配字节数
+    size_t string_bytes;     // 驻留字符串字节数
+    int string_count;        // 驻留字符串数量
+    int command_capacity;    // 命令表容量
+    int alias_capacity;      // 别名表容量
+} CommandMemoryStats;
+
 // 定义命令管理器结构体
 typedef struct CommandManager {
-    Command command_table[MAX_COMMANDS];  // 命令表
-    AliasEntry alias_table[MAX_ALIASES];  // 别名表
-    int command_count;                    // 已注册的命令数量
-    int alias_count;                      // 已注册的别名数量
+    Arena arena;                          // 注册表竞技场
+    StringPool strings;                   // 命令名与别名的驻留池
+    RegistryTable commands;               // 命令表
+    RegistryTable aliases;                // 别名表
+    int initialized;                      // 是否已初始化内存结构
 
     // 函数指针定义，作为“成员函数”来实现面向对象风格
     int (*register_command)(struct CommandManager* self, const char *name, CommandFunction func);
+    int (*register_schema_command)(struct CommandManager* self, const char *name, const CommandSchema *schema, CommandHandler handler);
     int (*register_alias)(struct CommandManager* self, const char *alias, const char *command_name);
     int (*execute_command)(struct CommandManager* self, const char *input);
+    int (*execute_by_id)(struct CommandManager* self, int id, int argc, char *argv[]); // 按编号执行已拆分参数的命令
+    int (*find_command)(struct CommandManager* self, const char *name); // 查找命令或别名对应的编号，未找到返回 COMMAND_ERROR_NOT_FOUND
     int (*get_command_count)(struct CommandManager* self);
     const char *(*get_command_name)(struct CommandManager* self, int index);
+    int (*get_alias_count)(struct CommandManager* self);
+    const AliasEntry *(*get_alias)(struct CommandManager* self, int index);
+
+    // 按参数模式生成用法文本，返回长度；命令没有参数模式时返回 -1
+    int (*format_usage)(struct CommandManager* self, int id, char *buffer, size_t size);
+
+    // 按参数模式补全行中最后一个词（选项名或枚举值），唯一匹配时返回候选并设置 word_start，否则返回 NULL
+    // 未编译 Tab 补全时为 NULL；成员始终存在，结构体布局不随编译选项变化（模块也经此结构体访问）
+    const char *(*complete_argument)(struct CommandManager* self, const char *line, int *word_start);
+
+    // 设置内存预算，不能小于已申请的内存
+    int (*set_memory_budget)(struct CommandManager* self, size_t budget);
+
+    // 获取注册表内存使用统计
+    void (*get_memory_stats)(struct CommandManager* self, CommandMemoryStats *stats);
 } CommandManager;
 
 // 获取命令管理器的单例指针
 CommandManager* get_command_manager();
 
+// 记录命令未找到，并附上最接近的已注册命令或别名；在查找失败处调用，序列中的每条都会报告
+void command_report_not_found(const char *name);
+
 #endif // COMMAND_H
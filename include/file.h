@@ -0,0 +1,47 @@
+#ifndef FILE_H
+#define FILE_H
+
+#include "shell_config.h"
+#include "command.h"
+
+#define FILE_MAP_WINDOW (4 * 1024 * 1024) // cat/tail 每次映射的窗口大小（页大小的整数倍）
+#define FILE_HEXDUMP_WIDTH 16             // hexdump 每行字节数
+#define FILE_HEXDUMP_LINE_SIZE 96         // hexdump 单行最大长度
+#define FILE_TAIL_DEFAULT_LINES 10        // tail 默认输出的行数
+#define FILE_TAIL_POLL 100                // tail -f 等待文件事件的间隔（毫秒），每次等待后检查退出键
+
+// cat/hexdump 将普通文件映射后直接交给 PAL 输出（大块时不经输出队列复制），读取期间文件被截短时
+// 捕获 SIGBUS 并报错；tail 可能读取正在增长或被截短的文件，始终用 pread/read。仅 Linux 可用
+
+// cat 命令的参数：cat <file...>
+typedef struct FileCatArgs {
+    CommandRest files;            // 依次输出的文件
+} FileCatArgs;
+
+// hexdump 命令的参数：hexdump <file>
+typedef struct FileHexdumpArgs {
+    const char *path;             // 文件路径
+} FileHexdumpArgs;
+
+// tail 命令的参数：tail [-n <lines>] [-f] <file>
+typedef struct FileTailArgs {
+    int lines;                    // 输出的行数
+    bool follow;                  // 是否持续跟踪
+    const char *path;             // 文件路径
+} FileTailArgs;
+
+// 各命令的参数模式
+extern const CommandSchema file_cat_schema;
+extern const CommandSchema file_hexdump_schema;
+extern const CommandSchema file_tail_schema;
+
+// cat 命令：依次输出各文件
+void file_cat_command(const void *args);
+
+// hexdump 命令：格式与 hexdump -C 相同，相同的行折叠为 '*'
+void file_hexdump_command(const void *args);
+
+// tail 命令：输出末尾若干行，-f 由 inotify 驱动，按 'q' 退出
+void file_tail_command(const void *args);
+
+#endif // FILE_H
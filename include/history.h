@@ -1,14 +1,31 @@
 #ifndef HISTORY_H
 #define HISTORY_H
 
-#define HISTORY_SIZE 50
-#define COMMAND_LENGTH 128
+#include "shell_config.h"
+
+#if SHELL_FEATURE_HINT
+#define HISTORY_HINT_GROWTH 1.05f       // 每条新命令的权重是上一条的倍数，越大越偏向最近使用
+#define HISTORY_HINT_RESCALE 1e6f       // 权重超过该值时整体缩小，防止浮点溢出
+
+// 提示索引中的一条不重复命令
+typedef struct HistoryHint {
+    char command[COMMAND_LENGTH];       // 命令文本
+    float score;                        // 频率和最近使用综合得分（frecency）
+} HistoryHint;
+#endif
 
 // 历史记录管理器结构体
 typedef struct HistoryManager {
     char history[HISTORY_SIZE][COMMAND_LENGTH]; // 存储历史命令
     int total_count;                            // 记录的命令总数
     int current_index;                          // 当前访问的命令索引
+#if SHELL_FEATURE_HINT
+    HistoryHint hints[HISTORY_HINT_SIZE];       // 提示索引，按得分从高到低排列
+    int hint_count;                             // 提示索引条数
+    float hint_weight;                          // 下一次使用计入的权重
+    char hint_prefix[COMMAND_LENGTH];           // 上一次查询的前缀
+    int hint_position;                          // 上一次查询命中的位置，之前的条目都不匹配该前缀
+#endif
 
     // 初始化历史记录管理器
     void (*init)(struct HistoryManager* self);
@@ -21,6 +38,11 @@ typedef struct HistoryManager {
 
     // 获取下一个历史记录
     const char* (*get_next)(struct HistoryManager* self);
+
+#if SHELL_FEATURE_HINT
+    // 查找以 prefix 开头且更长的得分最高的命令，返回其余下部分，没有时返回 NULL
+    const char* (*suggest)(struct HistoryManager* self, const char *prefix);
+#endif
 } HistoryManager;
 
 // 获取历史管理器的单例指针
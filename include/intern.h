@@ -0,0 +1,35 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+#define INTERN_INITIAL_CAPACITY 32   // 哈希索引初始槽位数（2 的幂）
+
+// 哈希索引槽位
+typedef struct InternSlot {
+    const char *str;     // 驻留字符串（存放在竞技场中），NULL 表示空槽
+    uint32_t hash;       // 字符串哈希值
+    uint32_t length;     // 字符串长度
+} InternSlot;
+
+// 字符串驻留池：相同内容只保存一份，按实际长度存放在竞技场中
+typedef struct StringPool {
+    Arena *arena;        // 字符串所在的竞技场
+    InternSlot *slots;   // 开放寻址哈希索引
+    size_t capacity;     // 槽位数
+    size_t count;        // 已驻留字符串数量
+    size_t bytes;        // 驻留字符串占用字节数（含 '\0'）
+
+    // 驻留字符串，返回池内唯一指针；超出预算时返回 NULL
+    const char *(*intern)(struct StringPool *self, const char *str, size_t length);
+
+    // 查找已驻留的字符串，不存在时返回 NULL（不会插入）
+    const char *(*find)(struct StringPool *self, const char *str, size_t length);
+} StringPool;
+
+// 初始化字符串驻留池
+void string_pool_init(StringPool *self, Arena *arena);
+
+#endif // INTERN_H
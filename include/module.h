@@ -0,0 +1,65 @@
+#ifndef MODULE_H
+#define MODULE_H
+
+#include <stdbool.h>
+#include "shell_config.h"
+#include "command.h"
+#include "arena.h"
+
+#define SHELL_MODULE_ABI 2                               // 模块接口版本（命令管理器和输出调度器结构体变化时递增）
+#define SHELL_MODULE_ABI_SYMBOL "shell_module_abi"       // 模块导出的接口版本（const int）
+#define SHELL_MODULE_COMMANDS_SYMBOL "shell_module_commands" // 模块导出的命令表
+#define MODULE_ARENA_BLOCK_SIZE 512                      // 模块路径存储的竞技场块大小
+#define MODULE_LINE_SIZE 256                             // 清单单行最大长度
+
+// 模块导出的命令表条目，表以 name 为 NULL 的条目结束：
+//   const ShellModuleCommand shell_module_commands[] = { { "uptime", uptime_command }, { NULL, NULL } };
+//   const int shell_module_abi = SHELL_MODULE_ABI;
+typedef struct ShellModuleCommand {
+    const char *name;              // 命令名，须与清单中的一致
+    CommandFunction function;      // 命令实现
+} ShellModuleCommand;
+
+// 清单中的一个模块
+typedef struct ModuleEntry {
+    const char *path;              // 共享库路径
+    void *handle;                  // dlopen 句柄，未加载时为 NULL
+    int active;                    // 正在执行的命令数，大于 0 时不会卸载
+    unsigned long calls;           // 调用次数
+    unsigned long loads;           // 加载次数
+    double last_used;              // 最近一次调用结束的单调时间（秒）
+} ModuleEntry;
+
+// 由模块提供的命令
+typedef struct ModuleCommand {
+    const char *name;              // 命令名（命令管理器中的驻留字符串）
+    int module;                    // 所属模块下标
+    CommandFunction function;      // 模块加载后解析出的实现，卸载时清空
+} ModuleCommand;
+
+// 模块管理器：启动时只按清单注册命令名，首次调用时才加载模块，空闲的模块可以卸载
+typedef struct ModuleManager {
+    Arena arena;                                  // 模块路径的存储
+    ModuleEntry modules[MODULE_MAX_MODULES];      // 模块表
+    int module_count;                             // 模块数
+    ModuleCommand commands[MODULE_MAX_COMMANDS];  // 模块命令表
+    int command_count;                            // 模块命令数
+    bool initialized;                             // 竞技场是否已初始化
+
+    // 读取清单并注册其中的命令名，不加载模块；返回注册的命令数，清单无法打开时返回 -1
+    int (*load_manifest)(struct ModuleManager *self, const char *path);
+
+    // 卸载空闲超过 idle_ms 毫秒的模块，返回卸载的模块数
+    int (*unload_idle)(struct ModuleManager *self, int idle_ms);
+
+    // 输出模块列表和加载状态
+    void (*print)(struct ModuleManager *self);
+} ModuleManager;
+
+// 获取模块管理器的单例指针
+ModuleManager* get_module_manager();
+
+// module 命令：module | module -u | module load <manifest>
+void module_command(int argc, char *argv[]);
+
+#endif // MODULE_H
@@ -0,0 +1,94 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "shell_config.h"
+
+#define OUTPUT_DRAIN_CHUNK 64           // 空闲时每次写出的日志字节数
+#define OUTPUT_PUSHBACK_SIZE 32         // 等待 XON 时暂存的输入字符数
+#define OUTPUT_DIRECT_CHUNK 4096        // 大块命令输出直接写出时的分块大小，分块之间检查 XOFF
+
+#define OUTPUT_XON 0x11                 // Ctrl-Q，恢复输出
+#define OUTPUT_XOFF 0x13                // Ctrl-S，暂停输出
+
+// 输出优先级，数值越小优先级越高
+typedef enum {
+    OUTPUT_PRIORITY_ECHO,     // 交互回显
+    OUTPUT_PRIORITY_COMMAND,  // 命令输出
+    OUTPUT_PRIORITY_LOG,      // 日志输出
+    OUTPUT_PRIORITY_COUNT
+} OutputPriority;
+
+// 环形输出队列
+typedef struct OutputQueue {
+    char *buffer;     // 存储区
+    size_t capacity;  // 容量
+    size_t head;      // 读位置
+    size_t length;    // 已排队字节数
+} OutputQueue;
+
+// 输出捕获回调，设置后命令输出和日志交给回调而不写出到串口
+typedef void (*OutputCaptureFunction)(void *context, OutputPriority priority, const char *data, size_t length);
+
+// 输出统计信息
+typedef struct OutputStats {
+    unsigned long dropped_messages;   // 丢弃的日志条数
+    unsigned long dropped_bytes;      // 丢弃的日志字节数
+    unsigned long coalesced_messages; // 合并的重复日志条数
+    unsigned long xoff_count;         // 收到 XOFF 的次数
+} OutputStats;
+
+// 输出调度器：按优先级排队输出，支持 XON/XOFF 流控，压力下丢弃或合并日志
+typedef struct OutputManager {
+    OutputQueue queues[OUTPUT_PRIORITY_COUNT]; // 各优先级队列
+    bool paused;                                // 是否收到 XOFF
+    OutputStats stats;                          // 统计信息
+    unsigned long pending_drops;                // 尚未提示的丢弃条数
+    char last_log[128];                         // 上一条日志（用于合并重复）
+    unsigned long repeat_count;                 // 上一条日志被合并的次数
+    int pushback[OUTPUT_PUSHBACK_SIZE];         // 暂存的输入字符
+    int pushback_count;                         // 暂存字符数
+    OutputCaptureFunction capture;              // 输出捕获回调
+    void *capture_context;                      // 捕获回调的上下文
+    bool input_detached;                        // 输入链路被占用（如经 RPC 调用命令），命令不能读取按键
+    bool input_refused;                         // input_detached 期间有命令申请读取按键
+
+    // 按优先级发送字符串；回显和命令输出立即写出，日志延迟到空闲时写出
+    void (*send)(struct OutputManager *self, OutputPriority priority, const char *str);
+
+    // 按优先级发送一段数据（可含 '\0'）；不小于命令队列容量的命令输出不经队列复制，直接从 data 写出
+    void (*send_buffer)(struct OutputManager *self, OutputPriority priority, const char *data, size_t length);
+
+    // 不经队列和捕获直接写出一段数据（如 RPC 应答帧）；流控暂停时先等待 XON，写出期间不读取输入
+    void (*write_direct)(struct OutputManager *self, const char *data, size_t length);
+
+    // 写出全部排队内容（流控暂停时不写出）
+    void (*flush)(struct OutputManager *self);
+
+    // 空闲时分块写出日志，有按键等待时立即让出
+    void (*service)(struct OutputManager *self);
+
+    // 读取一个输入字符，透明处理 XON/XOFF
+    int (*read_char)(struct OutputManager *self);
+
+    // 读取一个输入字符，先取暂存的字符，不处理 XON/XOFF；用于读取 RPC 帧内的字节
+    int (*read_raw)(struct OutputManager *self);
+
+    // 是否有待读取的输入（含暂存的字符），不阻塞；用于命令执行期间检查退出键
+    bool (*has_input)(struct OutputManager *self);
+
+    // 命令开始读取按键（如按 'q' 退出）前调用；输入链路被占用时返回 false 并记录到 input_refused
+    bool (*claim_input)(struct OutputManager *self);
+
+    // 设置输出捕获回调，func 为 NULL 时恢复正常输出
+    void (*set_capture)(struct OutputManager *self, OutputCaptureFunction func, void *context);
+
+    // 获取统计信息
+    void (*get_stats)(struct OutputManager *self, OutputStats *stats);
+} OutputManager;
+
+// 获取输出调度器的单例指针
+OutputManager* get_output_manager();
+
+#endif // OUTPUT_H
@@ -1,13 +1,19 @@
 #ifndef PAL_H
 #define PAL_H
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #define ENABLE_FREERTOS 0
 
 // 平台抽象层接口，用于不同平台的硬件抽象
 typedef struct {
     void (*init)();                  // 平台初始化函数
-    int (*get_char)();               // 从输入中读取一个字符
-    void (*uart_send)(const char *str); // 发送字符串到串口
+    int (*get_char)();               // 从输入中读取一个字符（阻塞），输入结束时返回 -1
+    bool (*is_key_pressed)();        // 检查是否有待读取的输入（非阻塞）
+    void (*uart_send)(const char *str); // 发送命令输出（经输出调度器排队）
+    void (*uart_send_buffer)(const char *data, size_t length); // 发送一段命令输出（可含 '\0'，大块时不经队列复制）
+    void (*uart_write)(const char *data, size_t length); // 直接写出到串口（不排队）
     void (*delay)(int ms);           // 延时函数，单位为毫秒
 } PalInterface;
 
@@ -0,0 +1,79 @@
+#ifndef PROC_H
+#define PROC_H
+
+#include <stdbool.h>
+#include "shell_config.h"
+#include "command.h"
+
+#define PROC_STAT_BUFFER_SIZE 512     // 单个 stat 文件的读取缓冲区
+#define PROC_RESCAN_SAMPLES 5         // 每隔多少次采样重新扫描 /proc 发现新任务
+#define PROC_NAME_SIZE 16             // 任务名长度（与内核 comm 一致）
+#define PROC_DEFAULT_LIMIT 20         // 默认显示的任务数
+#define PROC_BASELINE_DELAY 100       // 首次采样时取基准的间隔（毫秒）
+#define PROC_FD_HEADROOM 32           // 缓存描述符时给 RLIMIT_NOFILE 留出的余量
+
+// 排序方式
+typedef enum {
+    PROC_SORT_CPU,     // 按 CPU 占用降序
+    PROC_SORT_PID,     // 按 pid/tid 升序
+    PROC_SORT_NAME     // 按名称升序
+} ProcSortKey;
+
+// 单个任务的采样状态
+typedef struct ProcTask {
+    int pid;                          // 进程号
+    int tid;                          // 线程号
+    int fd;                           // 复用的 stat 文件描述符，-1 表示未缓存
+    char name[PROC_NAME_SIZE];        // 任务名
+    char state;                       // 运行状态
+    int nice;                         // nice 值
+    unsigned long long ticks;         // 最近一次采样的 utime + stime
+    unsigned long long delta;         // 与上一次采样之间的增量
+    unsigned long long start_time;    // 任务启动时间（节拍），变化说明 tid 已被新任务复用
+    unsigned int generation;          // 最近一次在扫描中出现的代数
+    bool fresh;                       // 新发现的任务，首次读取不计增量
+} ProcTask;
+
+// /proc 采样器：任务表、索引和解析缓冲区全部预先分配
+// 周期刷新（ps -w）期间缓存各任务的 stat 描述符，数量受 RLIMIT_NOFILE 限制；单次 ps 结束后全部关闭
+typedef struct ProcSampler {
+    ProcTask tasks[PROC_MAX_TASKS];   // 任务表
+    int task_count;                   // 任务数
+    int hash[PROC_HASH_SIZE];         // tid -> 任务下标 + 1
+    int order[PROC_MAX_TASKS];        // 排序用下标数组
+    char buffer[PROC_STAT_BUFFER_SIZE]; // stat 解析缓冲区
+    unsigned int generation;          // 扫描代数
+    unsigned long samples;            // 采样次数
+    double elapsed_ticks;             // 两次采样之间经过的时钟节拍数
+    double last_time;                 // 上一次采样的单调时间（秒）
+    bool persistent;                  // 是否缓存描述符（周期刷新期间）
+    int open_fds;                     // 已缓存的描述符数
+    int fd_limit;                     // 可缓存的描述符上限，0 表示尚未计算；遇到 EMFILE 时下调并保持
+
+    // 采样一次，返回任务数，失败返回 -1
+    int (*sample)(struct ProcSampler *self);
+
+    // 按排序方式输出前 limit 个任务
+    void (*print)(struct ProcSampler *self, ProcSortKey key, int limit);
+
+    // 关闭全部缓存的描述符
+    void (*release)(struct ProcSampler *self);
+} ProcSampler;
+
+// 获取 /proc 采样器的单例指针
+ProcSampler* get_proc_sampler();
+
+// ps 命令的参数：ps [-s cpu|pid|name] [-n <count>] [-w <ms>]
+typedef struct ProcPsArgs {
+    int sort;                     // ProcSortKey
+    int limit;                    // 显示的任务数
+    int refresh;                  // 刷新间隔（毫秒），0 表示只输出一次
+} ProcPsArgs;
+
+// ps 命令的参数模式
+extern const CommandSchema proc_ps_schema;
+
+// ps 命令的 Linux 实现：参数已按 proc_ps_schema 解析
+void proc_ps_command(const void *args);
+
+#endif // PROC_H
@@ -0,0 +1,65 @@
+#ifndef RPC_H
+#define RPC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 帧格式（多字节字段均为小端）：
+//   SYNC0 SYNC1 | type(1) | request_id(2) | length(2) | payload(length) | crc16(2)
+// CRC-16/CCITT-FALSE 覆盖 type 到 payload 末尾。
+// 帧以 SYNC0 开头出现在行首时，shell 将其作为二进制请求处理，与文本控制台共用同一条 PAL 链路。
+// 请求按到达顺序逐个执行（流水线，不是多路复用）：主机可以连续发送多个请求而不必等待，
+// 应答帧携带相同的 request_id 用于匹配，但前一个请求结束前不会开始处理下一个。
+// XON/XOFF 只在帧之间识别，帧内字节原样读取；主机发送 XOFF 后应答帧等待 XON，暂停期间主机只应发送 XON。
+// 长度超限或 CRC 错误的帧应答错误状态后被丢弃，随后跳过字节直到下一个 SYNC0 或线路空闲。
+// 需要读取按键的命令（watch、tail -f、ps -w）经 CALL 调用时不运行，应答 RPC_STATUS_NEEDS_INPUT。
+#define RPC_SYNC0 0xA5
+#define RPC_SYNC1 0x5A
+#define RPC_HEADER_SIZE 7
+#define RPC_MAX_PAYLOAD 256
+#define RPC_MAX_ARGS 10
+#define RPC_BYTE_TIMEOUT 100   // 帧内字节间隔超时（毫秒），超时的帧被丢弃，控制台恢复
+
+// 请求帧类型（主机 -> 设备）
+#define RPC_REQ_PING 0x01      // 心跳，应答 STATUS
+#define RPC_REQ_LIST 0x02      // 列出命令：DATA 帧内为 [id(2) len(1) name] 序列
+#define RPC_REQ_CALL 0x03      // 调用命令：payload 为 [id(2) argc(1) 以 '\0' 结尾的参数...]
+
+// 应答帧类型（设备 -> 主机）
+#define RPC_RSP_STATUS 0x81    // 请求结束，payload 为 int16 状态码
+#define RPC_RSP_DATA 0x82      // 命令输出数据
+#define RPC_RSP_LOG 0x83       // 命令执行期间产生的日志
+
+// RPC 状态码，0 及 COMMAND_ERROR_* 直接透传命令执行结果
+#define RPC_STATUS_OK 0
+#define RPC_STATUS_BAD_CRC -16      // CRC 校验失败
+#define RPC_STATUS_BAD_FRAME -17    // 帧格式错误（长度超限、同步字错误）
+#define RPC_STATUS_BAD_REQUEST -18  // 未知请求类型或参数格式错误
+#define RPC_STATUS_NEEDS_INPUT -19  // 命令需要读取按键（如 watch、tail -f），不能经 RPC 调用
+
+// 应答缓冲区，攒满一帧再发送
+typedef struct RpcBuffer {
+    uint8_t type;                    // 应答帧类型
+    size_t length;                   // 已缓存字节数
+    uint8_t data[RPC_MAX_PAYLOAD];   // 缓存数据
+} RpcBuffer;
+
+// 二进制 RPC 管理器
+typedef struct RpcManager {
+    uint16_t request_id;             // 当前处理的请求编号
+    RpcBuffer output;                // 命令输出缓冲
+    RpcBuffer log;                   // 日志缓冲
+    unsigned long frames_received;   // 已接收的有效帧数
+    unsigned long frames_rejected;   // 被拒绝的帧数
+
+    // 处理一帧请求，first_byte 为已读取的第一个同步字节
+    void (*handle_frame)(struct RpcManager *self, int first_byte);
+} RpcManager;
+
+// 计算 CRC-16/CCITT-FALSE
+uint16_t rpc_crc16(uint16_t crc, const uint8_t *data, size_t length);
+
+// 获取 RPC 管理器的单例指针
+RpcManager* get_rpc_manager();
+
+#endif // RPC_H
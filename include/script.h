@@ -0,0 +1,92 @@
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "shell_config.h"
+
+#define SCRIPT_MAX_INSTRS 256         // 单个脚本最大指令数
+#define SCRIPT_MAX_WORDS 512          // 单个脚本最大单词数
+#define SCRIPT_MAX_SLOTS 8            // for 循环最大嵌套数
+#define SCRIPT_MAX_STEPS 100000       // 单次运行最多执行的指令数，防止死循环
+#define SCRIPT_NAME_SIZE 16           // 变量名长度上限
+#define SCRIPT_VALUE_SIZE 64          // 变量值长度上限
+#define SCRIPT_ARG_BUFFER_SIZE 256    // 单条命令展开后的参数缓冲区大小
+
+// 脚本错误码（与 COMMAND_ERROR_* 共用负数空间）
+#define SCRIPT_ERROR_SYNTAX -10       // 语法错误
+#define SCRIPT_ERROR_TOO_LARGE -11    // 脚本超出大小限制
+#define SCRIPT_ERROR_STEP_LIMIT -12   // 超出执行步数限制
+
+// 字节码操作码
+typedef enum {
+    SCRIPT_OP_EXEC,           // 执行命令，设置状态
+    SCRIPT_OP_JUMP,           // 无条件跳转
+    SCRIPT_OP_JUMP_IF_FAIL,   // 状态非 0 时跳转
+    SCRIPT_OP_JUMP_IF_OK,     // 状态为 0 时跳转
+    SCRIPT_OP_FOR_INIT,       // 重置 for 循环计数
+    SCRIPT_OP_FOR_NEXT        // 取下一个元素赋给循环变量，取完时跳转
+} ScriptOpcode;
+
+// 字节码指令
+typedef struct ScriptInstr {
+    uint8_t op;          // 操作码
+    uint8_t argc;        // EXEC：单词数；FOR_NEXT：列表元素数
+    uint16_t word;       // EXEC：首个单词；FOR_NEXT：首个列表元素
+    int16_t command;     // EXEC：命令编号或内置命令；FOR_*：循环槽位
+    uint16_t arg;        // FOR_NEXT：循环变量名所在单词
+    uint16_t target;     // 跳转目标
+} ScriptInstr;
+
+// 预先拆分好的单词，文本存放在脚本字符池中
+typedef struct ScriptWord {
+    uint16_t offset;     // 在字符池中的偏移
+    uint16_t length;     // 长度
+    uint8_t expand;      // 是否需要变量展开（此时 '$' 和 '\' 以 '\' 转义）
+} ScriptWord;
+
+// 编译后的脚本（整体一次分配）
+typedef struct CompiledScript {
+    uint32_t hash;           // 源码哈希
+    uint32_t source_length;  // 源码长度
+    unsigned long last_used; // 最近使用时间（LRU）
+    int running;             // 正在执行的层数，执行中不会被淘汰
+    uint16_t instr_count;    // 指令数
+    uint16_t word_count;     // 单词数
+    const char *source;      // 源码副本，用于校验哈希命中
+    const ScriptInstr *instrs;
+    const ScriptWord *words;
+    const char *pool;        // 单词字符池
+} CompiledScript;
+
+// 脚本变量
+typedef struct ScriptVariable {
+    char name[SCRIPT_NAME_SIZE];
+    char value[SCRIPT_VALUE_SIZE];
+} ScriptVariable;
+
+// 脚本解释器：支持 ; && || 、变量、if/while/until/for，编译结果按源码哈希缓存
+typedef struct ScriptManager {
+    CompiledScript *cache[SCRIPT_CACHE_SIZE];     // 编译缓存
+    unsigned long clock;                          // LRU 时钟
+    unsigned long cache_hits;                     // 缓存命中次数
+    unsigned long cache_misses;                   // 缓存未命中次数
+    ScriptVariable variables[SCRIPT_MAX_VARIABLES];
+    int variable_count;
+    int last_status;                              // 上一条命令的状态（$?）
+    char error[64];                               // 最近一次语法错误描述
+
+    // 编译（或命中缓存）并运行脚本，返回最后一条命令的状态
+    int (*run)(struct ScriptManager *self, const char *source);
+
+    // 读取变量，不存在时返回 NULL
+    const char *(*get_variable)(struct ScriptManager *self, const char *name);
+
+    // 设置变量，成功返回 0
+    int (*set_variable)(struct ScriptManager *self, const char *name, const char *value);
+} ScriptManager;
+
+// 获取脚本解释器的单例指针
+ScriptManager* get_script_manager();
+
+#endif // SCRIPT_H
@@ -1,14 +1,19 @@
 #ifndef SHELL_H
 #define SHELL_H
 
+#include "shell_config.h"
 #include "command.h"
 #include "history.h"
 #include "pal.h"
 #include "log.h"  // 引入日志头文件
+#include "output.h"
+#include "rpc.h"
+#include "script.h"
 
 #define SHELL_VERSION "1.0.0"
-#define INPUT_BUFFER_SIZE 128
 #define DEFAULT_PASSWORD "1234" // 这是示例密码
+#define SHELL_PASTE_BEGIN 200   // 括号粘贴开始序列 ESC[200~ 的参数
+#define SHELL_PASTE_END "\033[201~" // 括号粘贴结束序列
 
 typedef enum {
     EVENT_NONE,
@@ -24,18 +29,34 @@ typedef enum {
 
 typedef struct Shell {
     CommandManager *command_manager;   // 命令管理器
+#if SHELL_FEATURE_HISTORY
     HistoryManager *history_manager;   // 历史记录管理器
+#endif
     PalInterface *pal;                 // 平台抽象层接口指针
     LogManager *log_manager;           // 日志管理器
+    OutputManager *output_manager;     // 输出调度器
+#if SHELL_FEATURE_RPC
+    RpcManager *rpc_manager;           // 二进制 RPC 管理器
+#endif
+#if SHELL_FEATURE_SCRIPT
+    ScriptManager *script_manager;     // 脚本解释器
+#endif
 
     char input_buffer[INPUT_BUFFER_SIZE]; // 输入缓冲区
     int buffer_length;                 // 当前输入缓冲区的长度
     int cursor_position;               // 当前游标位置
+#if SHELL_FEATURE_PASTE
+    char paste_buffer[SHELL_PASTE_BUFFER_SIZE]; // 粘贴内容中尚未插入的部分（换行已统一为 '\n'）
+    int paste_length;                  // paste_buffer 中的字节数
+#endif
+#if SHELL_FEATURE_HISTORY && SHELL_FEATURE_HINT
+    const char *hint;                  // 行尾正在显示的历史提示（命令的剩余部分），未显示时为 NULL
+#endif
 
     // 初始化 shell，包括平台、命令和历史管理器
     void (*init)(struct Shell *self);
 
-    // shell 主循环
+    // shell 主循环，输入关闭时返回
     void (*loop)(struct Shell *self);
 
     // 注册命令
@@ -44,8 +65,10 @@ typedef struct Shell {
     // 事件处理器
     void (*handle_event)(struct Shell *self, ShellEvent event, int data);
 
+#if SHELL_FEATURE_LOGIN
     // 验证密码函数
     bool (*verify_password)(struct Shell *self, const char *password); 
+#endif
 } Shell;
 
 // 创建并初始化 Shell 实例
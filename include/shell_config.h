@@ -0,0 +1,254 @@
+#ifndef SHELL_CONFIG_H
+#define SHELL_CONFIG_H
+
+// 编译期配置：功能开关和各缓冲区大小集中在此处。
+// 所有选项都可以在命令行用 -D 覆盖；make PROFILE=<full|minimal|tiny> 选择一组预设。
+// 关闭的功能整体不参与编译，对应的 RAM 和 ROM 都不会占用（make footprint 查看各功能的占用）。
+
+// ========== 预设 ==========
+
+#if defined(SHELL_PROFILE_TINY)
+// 极小目标：只保留命令解析和输出调度
+#ifndef SHELL_FEATURE_HISTORY
+#define SHELL_FEATURE_HISTORY 0
+#endif
+#ifndef SHELL_FEATURE_COMPLETION
+#define SHELL_FEATURE_COMPLETION 0
+#endif
+#ifndef SHELL_FEATURE_LOGIN
+#define SHELL_FEATURE_LOGIN 0
+#endif
+#ifndef SHELL_FEATURE_LOG_COLOR
+#define SHELL_FEATURE_LOG_COLOR 0
+#endif
+#ifndef SHELL_FEATURE_LOGO
+#define SHELL_FEATURE_LOGO 0
+#endif
+#ifndef SHELL_FEATURE_SCRIPT
+#define SHELL_FEATURE_SCRIPT 0
+#endif
+#ifndef SHELL_FEATURE_RPC
+#define SHELL_FEATURE_RPC 0
+#endif
+#ifndef SHELL_FEATURE_WATCH
+#define SHELL_FEATURE_WATCH 0
+#endif
+#ifndef SHELL_FEATURE_PROC
+#define SHELL_FEATURE_PROC 0
+#endif
+#ifndef SHELL_FEATURE_FILE
+#define SHELL_FEATURE_FILE 0
+#endif
+#ifndef SHELL_FEATURE_MODULES
+#define SHELL_FEATURE_MODULES 0
+#endif
+#ifndef SHELL_FEATURE_SUGGEST
+#define SHELL_FEATURE_SUGGEST 0
+#endif
+#ifndef SHELL_FEATURE_PASTE
+#define SHELL_FEATURE_PASTE 0
+#endif
+#ifndef SHELL_FEATURE_HINT
+#define SHELL_FEATURE_HINT 0
+#endif
+#ifndef INPUT_BUFFER_SIZE
+#define INPUT_BUFFER_SIZE 64
+#endif
+#ifndef MAX_ARGC
+#define MAX_ARGC 6
+#endif
+#ifndef COMMAND_MEMORY_BUDGET
+#define COMMAND_MEMORY_BUDGET (2 * 1024)
+#endif
+#ifndef OUTPUT_ECHO_QUEUE_SIZE
+#define OUTPUT_ECHO_QUEUE_SIZE 64
+#endif
+#ifndef OUTPUT_COMMAND_QUEUE_SIZE
+#define OUTPUT_COMMAND_QUEUE_SIZE 256
+#endif
+#ifndef OUTPUT_LOG_QUEUE_SIZE
+#define OUTPUT_LOG_QUEUE_SIZE 128
+#endif
+#ifndef LOG_LINE_SIZE
+#define LOG_LINE_SIZE 96
+#endif
+
+#elif defined(SHELL_PROFILE_MINIMAL)
+// 小型 MCU：保留交互功能，去掉脚本、RPC 和全屏视图，缩小各缓冲区
+#ifndef SHELL_FEATURE_LOGO
+#define SHELL_FEATURE_LOGO 0
+#endif
+#ifndef SHELL_FEATURE_SCRIPT
+#define SHELL_FEATURE_SCRIPT 0
+#endif
+#ifndef SHELL_FEATURE_RPC
+#define SHELL_FEATURE_RPC 0
+#endif
+#ifndef SHELL_FEATURE_WATCH
+#define SHELL_FEATURE_WATCH 0
+#endif
+#ifndef SHELL_FEATURE_PROC
+#define SHELL_FEATURE_PROC 0
+#endif
+#ifndef SHELL_FEATURE_FILE
+#define SHELL_FEATURE_FILE 0
+#endif
+#ifndef SHELL_FEATURE_MODULES
+#define SHELL_FEATURE_MODULES 0
+#endif
+#ifndef HISTORY_SIZE
+#define HISTORY_SIZE 8
+#endif
+#ifndef HISTORY_HINT_SIZE
+#define HISTORY_HINT_SIZE 8
+#endif
+#ifndef COMMAND_LENGTH
+#define COMMAND_LENGTH 80
+#endif
+#ifndef INPUT_BUFFER_SIZE
+#define INPUT_BUFFER_SIZE 80
+#endif
+#ifndef MAX_INPUT_SIZE
+#define MAX_INPUT_SIZE 80
+#endif
+#ifndef COMMAND_MEMORY_BUDGET
+#define COMMAND_MEMORY_BUDGET (4 * 1024)
+#endif
+#ifndef OUTPUT_COMMAND_QUEUE_SIZE
+#define OUTPUT_COMMAND_QUEUE_SIZE 512
+#endif
+#ifndef OUTPUT_LOG_QUEUE_SIZE
+#define OUTPUT_LOG_QUEUE_SIZE 256
+#endif
+#ifndef LOG_LINE_SIZE
+#define LOG_LINE_SIZE 128
+#endif
+#ifndef SHELL_PASTE_BUFFER_SIZE
+#define SHELL_PASTE_BUFFER_SIZE 256
+#endif
+#endif
+
+// ========== 功能开关（1 启用，0 裁剪） ==========
+
+#ifndef SHELL_FEATURE_HISTORY
+#define SHELL_FEATURE_HISTORY 1     // 命令历史（上下方向键）
+#endif
+#ifndef SHELL_FEATURE_COMPLETION
+#define SHELL_FEATURE_COMPLETION 1  // Tab 补全
+#endif
+#ifndef SHELL_FEATURE_LOGIN
+#define SHELL_FEATURE_LOGIN 1       // 启动时密码登录
+#endif
+#ifndef SHELL_FEATURE_LOG_COLOR
+#define SHELL_FEATURE_LOG_COLOR 1   // 日志和 Logo 的 ANSI 颜色
+#endif
+#ifndef SHELL_FEATURE_LOGO
+#define SHELL_FEATURE_LOGO 1        // 启动时的字符画 Logo
+#endif
+#ifndef SHELL_FEATURE_SCRIPT
+#define SHELL_FEATURE_SCRIPT 1      // 脚本解释器和 source 命令，关闭时每行按单条命令执行
+#endif
+#ifndef SHELL_FEATURE_RPC
+#define SHELL_FEATURE_RPC 1         // 二进制 RPC 帧
+#endif
+#ifndef SHELL_FEATURE_WATCH
+#define SHELL_FEATURE_WATCH 1       // watch 命令（以及 ps -w）
+#endif
+#ifndef SHELL_FEATURE_PROC
+#define SHELL_FEATURE_PROC 1        // Linux 上基于 /proc 的 ps
+#endif
+#ifndef SHELL_FEATURE_SUGGEST
+#define SHELL_FEATURE_SUGGEST 1     // 命令未找到时给出相近的命令
+#endif
+#ifndef SHELL_FEATURE_FILE
+#define SHELL_FEATURE_FILE 1        // Linux 上的 cat、hexdump 和 tail -f
+#endif
+#ifndef SHELL_FEATURE_PASTE
+#define SHELL_FEATURE_PASTE 1       // 括号粘贴：整块插入，多行粘贴逐行执行
+#endif
+#ifndef SHELL_FEATURE_HINT
+#define SHELL_FEATURE_HINT 1        // 输入时按频率和最近使用给出历史命令提示（需要 HISTORY）
+#endif
+#ifndef SHELL_FEATURE_MODULES
+#define SHELL_FEATURE_MODULES 1     // Linux 上按清单延迟加载的命令模块（dlopen）
+#endif
+
+// ========== 缓冲区大小 ==========
+
+#ifndef INPUT_BUFFER_SIZE
+#define INPUT_BUFFER_SIZE 128                // 行编辑输入缓冲区
+#endif
+#ifndef SHELL_PASTE_BUFFER_SIZE
+#define SHELL_PASTE_BUFFER_SIZE 1024         // 粘贴缓冲区，保存多行粘贴中尚未执行的行
+#endif
+#ifndef HISTORY_SIZE
+#define HISTORY_SIZE 50                      // 历史记录条数
+#endif
+#ifndef COMMAND_LENGTH
+#define COMMAND_LENGTH 128                   // 每条历史记录的长度
+#endif
+#ifndef HISTORY_HINT_SIZE
+#define HISTORY_HINT_SIZE 32                 // 历史提示索引中不重复命令的条数
+#endif
+#ifndef MAX_ARGC
+#define MAX_ARGC 10                          // 单条命令的参数个数上限
+#endif
+#ifndef MAX_INPUT_SIZE
+#define MAX_INPUT_SIZE 128                   // 命令解析时的输入副本长度
+#endif
+#ifndef COMMAND_MEMORY_BUDGET
+#define COMMAND_MEMORY_BUDGET (16 * 1024)    // 命令注册表内存预算，取代固定的命令个数上限
+#endif
+#ifndef OUTPUT_ECHO_QUEUE_SIZE
+#define OUTPUT_ECHO_QUEUE_SIZE 256           // 交互回显队列
+#endif
+#ifndef OUTPUT_COMMAND_QUEUE_SIZE
+#define OUTPUT_COMMAND_QUEUE_SIZE 2048       // 命令输出队列
+#endif
+#ifndef OUTPUT_LOG_QUEUE_SIZE
+#define OUTPUT_LOG_QUEUE_SIZE 1024           // 日志输出队列
+#endif
+#ifndef LOG_LINE_SIZE
+#define LOG_LINE_SIZE 256                    // 单条日志的拼接缓冲区
+#endif
+#ifndef SCRIPT_MAX_SOURCE
+#define SCRIPT_MAX_SOURCE 2048               // 单个脚本源码最大长度
+#endif
+#ifndef SCRIPT_CACHE_SIZE
+#define SCRIPT_CACHE_SIZE 8                  // 脚本编译缓存条目数
+#endif
+#ifndef SCRIPT_MAX_DEPTH
+#define SCRIPT_MAX_DEPTH 4                   // source 嵌套层数上限，每层占用一个 SCRIPT_MAX_SOURCE 静态缓冲区
+#endif
+#ifndef SCRIPT_MAX_VARIABLES
+#define SCRIPT_MAX_VARIABLES 32              // 脚本变量个数上限
+#endif
+#ifndef WATCH_MAX_LINES
+#define WATCH_MAX_LINES 48                   // watch 屏幕缓冲行数
+#endif
+#ifndef WATCH_LINE_WIDTH
+#define WATCH_LINE_WIDTH 120                 // watch 屏幕缓冲列数
+#endif
+#ifndef PROC_MAX_TASKS
+#define PROC_MAX_TASKS 4096                  // ps 跟踪的任务数上限
+#endif
+#ifndef PROC_HASH_SIZE
+#define PROC_HASH_SIZE 8192                  // ps 的 tid 哈希索引大小（2 的幂）
+#endif
+#ifndef FILE_BUFFER_SIZE
+#define FILE_BUFFER_SIZE 4096                // hexdump 输出块和 tail -f 读取缓冲区
+#endif
+#ifndef MODULE_MAX_MODULES
+#define MODULE_MAX_MODULES 16                // 模块个数上限
+#endif
+#ifndef MODULE_MAX_COMMANDS
+#define MODULE_MAX_COMMANDS 64               // 模块命令个数上限
+#endif
+#ifndef MODULE_IDLE_TIMEOUT
+#define MODULE_IDLE_TIMEOUT 60000            // 模块空闲多久后卸载（毫秒）
+#endif
+#ifndef SHELL_MODULE_MANIFEST
+#define SHELL_MODULE_MANIFEST "modules/modules.conf" // 启动时读取的模块清单
+#endif
+
+#endif // SHELL_CONFIG_H
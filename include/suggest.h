@@ -0,0 +1,30 @@
+#ifndef SUGGEST_H
+#define SUGGEST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SUGGEST_MAX_RESULTS 3        // 最多给出的建议数
+#define SUGGEST_MAX_PATTERN 64       // 参与比较的名称最大长度（一个 64 位字）
+
+// 单条建议
+typedef struct Suggestion {
+    const char *name;                // 命令或别名（驻留字符串）
+    int distance;                    // 编辑距离
+} Suggestion;
+
+// 拼写建议管理器：用 Myers 位并行算法计算编辑距离
+typedef struct SuggestManager {
+    uint64_t peq[256];               // 模式中各字符出现位置的位掩码
+
+    // 在命令和别名中查找与 name 最接近的若干项，返回建议数
+    int (*suggest)(struct SuggestManager *self, const char *name, Suggestion *results, int max_results);
+
+    // 生成 "Did you mean: a, b?" 形式的提示，没有建议时返回 0
+    int (*format)(struct SuggestManager *self, const char *name, char *buffer, size_t size);
+} SuggestManager;
+
+// 获取拼写建议管理器的单例指针
+SuggestManager* get_suggest_manager();
+
+#endif // SUGGEST_H
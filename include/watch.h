@@ -0,0 +1,43 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <stddef.h>
+#include "shell_config.h"
+#include "command.h"
+
+#define WATCH_DEFAULT_INTERVAL 1000   // 默认刷新间隔（毫秒）
+#define WATCH_MIN_INTERVAL 50         // 最小刷新间隔（毫秒），更小的值按此间隔刷新
+#define WATCH_MAX_INTERVAL 3600000    // -n 允许的最大值（毫秒）
+#define WATCH_POLL_SLICE 20           // 等待期间检查按键的间隔（毫秒）
+#define WATCH_FIRST_ROW 3             // 命令输出起始行（第 1 行为标题）
+
+// 一屏输出内容
+typedef struct WatchFrame {
+    char lines[WATCH_MAX_LINES][WATCH_LINE_WIDTH + 1]; // 各行内容（已去除 ANSI 控制序列）
+    int line_count;                                    // 行数
+    int column;                                        // 捕获时的当前列
+    int escape;                                        // 是否处于 ANSI 控制序列中
+} WatchFrame;
+
+// watch 状态：保存上一屏用于增量重绘
+typedef struct WatchState {
+    WatchFrame previous;          // 上一屏
+    WatchFrame current;           // 当前屏
+    unsigned long refreshes;      // 刷新次数
+    unsigned long bytes_sent;     // 实际发送的字节数
+    unsigned long bytes_full;     // 若整屏重绘需要发送的字节数
+} WatchState;
+
+// watch 命令的参数：watch [-n <ms>] <command...>
+typedef struct WatchArgs {
+    int interval;                 // 刷新间隔（毫秒）
+    CommandRest command;          // 要执行的命令
+} WatchArgs;
+
+// watch 命令的参数模式
+extern const CommandSchema watch_schema;
+
+// watch 命令：按 watch_schema 解析后的 WatchArgs 执行，按 'q' 退出
+void watch_command(const void *args);
+
+#endif // WATCH_H
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include "module.h"
+#include "pal.h"
+#include "log.h"
+
+// uptime 命令实现：系统运行时间和平均负载
+static void uptime_command(int argc, char *argv[]) {
+    double uptime = 0;
+    double load[3] = { 0, 0, 0 };
+    FILE *file = fopen("/proc/uptime", "r");
+    if (file == NULL || fscanf(file, "%lf", &uptime) != 1) {
+        get_log_manager()->log(LOG_LEVEL_ERROR, "uptime: cannot read /proc/uptime.");
+        if (file != NULL) {
+            fclose(file);
+        }
+        return;
+    }
+    fclose(file);
+    file = fopen("/proc/loadavg", "r");
+    if (file != NULL) {
+        if (fscanf(file, "%lf %lf %lf", &load[0], &load[1], &load[2]) != 3) {
+            load[0] = load[1] = load[2] = 0;
+        }
+        fclose(file);
+    }
+
+    unsigned long seconds = (unsigned long)uptime;
+    char line[96];
+    snprintf(line, sizeof(line), "up %lu day(s), %02lu:%02lu:%02lu, load average: %.2f, %.2f, %.2f\n",
+             seconds / 86400, seconds / 3600 % 24, seconds / 60 % 60, seconds % 60, load[0], load[1], load[2]);
+    get_pal_interface()->uart_send(line);
+}
+
+// free 命令实现：内存使用情况（KiB）
+static void free_command(int argc, char *argv[]) {
+    static const char *keys[] = { "MemTotal", "MemFree", "MemAvailable", "Buffers", "Cached", "SwapTotal", "SwapFree" };
+    unsigned long values[7] = { 0 };
+    char line[128];
+
+    FILE *file = fopen("/proc/meminfo", "r");
+    if (file == NULL) {
+        get_log_manager()->log(LOG_LEVEL_ERROR, "free: cannot read /proc/meminfo.");
+        return;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        for (int i = 0; i < 7; i++) {
+            size_t length = strlen(keys[i]);
+            if (strncmp(line, keys[i], length) == 0 && line[length] == ':') {
+                sscanf(line + length + 1, "%lu", &values[i]);
+            }
+        }
+    }
+    fclose(file);
+
+    PalInterface *pal = get_pal_interface();
+    pal->uart_send("          total       used       free  available  buff/cache\n");
+    snprintf(line, sizeof(line), "Mem: %10lu %10lu %10lu %10lu  %10lu\n", values[0],
+             values[0] - values[1] - values[3] - values[4], values[1], values[2], values[3] + values[4]);
+    pal->uart_send(line);
+    snprintf(line, sizeof(line), "Swap:%10lu %10lu %10lu\n", values[5], values[5] - values[6], values[6]);
+    pal->uart_send(line);
+}
+
+// uname 命令实现：uname [-a]
+static void uname_command(int argc, char *argv[]) {
+    struct utsname info;
+    char line[sizeof(info) + 8];
+    if (uname(&info) != 0) {
+        get_log_manager()->log(LOG_LEVEL_ERROR, "uname: failed.");
+        return;
+    }
+    if (argc > 1 && strcmp(argv[1], "-a") == 0) {
+        snprintf(line, sizeof(line), "%s %s %s %s %s\n",
+                 info.sysname, info.nodename, info.release, info.version, info.machine);
+    } else {
+        snprintf(line, sizeof(line), "%s\n", info.sysname);
+    }
+    get_pal_interface()->uart_send(line);
+}
+
+// 模块导出的命令表和接口版本
+const ShellModuleCommand shell_module_commands[] = {
+    { "uptime", uptime_command },
+    { "free", free_command },
+    { "uname", uname_command },
+    { NULL, NULL },
+};
+const int shell_module_abi = SHELL_MODULE_ABI;
@@ -0,0 +1,42 @@
+#!/bin/sh
+# 统计各构建预设和各功能的 ROM/RAM 占用（make footprint）。
+# ROM = text + data，RAM = data + bss，只计静态分配部分，不含堆上的命令注册表和脚本编译缓存。
+# 交叉编译目标：make footprint CC=arm-none-eabi-gcc SIZE=arm-none-eabi-size
+
+CC=${CC:-gcc}
+SIZE=${SIZE:-size}
+CFLAGS="-Os -Iinclude"
+FEATURES="HISTORY COMPLETION LOGIN LOG_COLOR LOGO SCRIPT RPC WATCH PROC SUGGEST FILE PASTE MODULES HINT"
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# 用给定的宏编译全部源文件，输出 "ROM RAM"
+measure() {
+    rm -f "$work"/*.o
+    for src in src/*.c; do
+        $CC $CFLAGS "$@" -c "$src" -o "$work/$(basename "$src" .c).o" || exit 1
+    done
+    $SIZE -t "$work"/*.o | awk '$NF == "(TOTALS)" { print $1 + $2, $2 + $3 }'
+}
+
+printf '%-24s %10s %10s\n' "Profile" "ROM" "RAM"
+for profile in full minimal tiny; do
+    case $profile in
+        full) flags="" ;;
+        minimal) flags="-DSHELL_PROFILE_MINIMAL" ;;
+        tiny) flags="-DSHELL_PROFILE_TINY" ;;
+    esac
+    set -- $(measure $flags)
+    [ $# -eq 2 ] || exit 1
+    printf '%-24s %10s %10s\n' "$profile" "$1" "$2"
+    [ "$profile" = full ] && full_rom=$1 && full_ram=$2
+done
+
+echo
+printf '%-24s %10s %10s\n' "Feature (full profile)" "ROM" "RAM"
+for feature in $FEATURES; do
+    set -- $(measure "-DSHELL_FEATURE_$feature=0")
+    [ $# -eq 2 ] || exit 1
+    printf '%-24s %10s %10s\n' "SHELL_FEATURE_$feature" "$((full_rom - $1))" "$((full_ram - $2))"
+done
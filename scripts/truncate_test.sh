@@ -0,0 +1,29 @@
+#!/bin/sh
+# 读取期间文件被截短时，cat/hexdump 必须报错而不是静默输出不完整的内容（make check）。
+# cat 的大块输出直接从映射区 write，截短后 write 返回 EFAULT；hexdump 访问映射区时触发 SIGBUS。
+# 输出经慢速管道读取，保证截短发生在读取途中。
+
+SHELL_BIN=${SHELL_BIN:-./shell}
+PASSWORD=$(sed -n 's/^#define DEFAULT_PASSWORD "\([^"]*\)".*/\1/p' include/shell.h)
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# 截短期间执行 "<命令> <文件>"，随后的 hello 用来确认 shell 仍然存活
+run() {
+    head -c 48000000 /dev/urandom | base64 -w 100 > "$work/big.txt"
+    printf '%s\n%s %s\nhello\nexit\n' "$PASSWORD" "$1" "$work/big.txt" | "$SHELL_BIN" 2>&1 |
+        (sleep 0.3; : > "$work/big.txt"; cat) > "$work/out.txt"
+    if ! grep -aq "$1: $work/big.txt: Input/output error" "$work/out.txt"; then
+        echo "FAIL: $1 did not report the truncation"
+        exit 1
+    fi
+    if ! grep -aq "Hello, World!" "$work/out.txt"; then
+        echo "FAIL: shell did not survive $1"
+        exit 1
+    fi
+    echo "PASS: $1"
+}
+
+run cat
+run hexdump
@@ -0,0 +1,81 @@
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+// 向上对齐到 ARENA_ALIGNMENT
+static size_t arena_align(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+// 检查再申请 bytes 字节是否仍在预算内
+static bool arena_within_budget(Arena *self, size_t bytes) {
+    return self->budget == 0 || self->reserved + bytes <= self->budget;
+}
+
+// 分配内存：优先使用当前块，不足时申请新块
+static void *arena_alloc(Arena *self, size_t size) {
+    size = arena_align(size);
+
+    ArenaBlock *block = self->head;
+    if (block == NULL || block->capacity - block->used < size) {
+        size_t capacity = size > self->block_size ? size : self->block_size;
+        size_t total = sizeof(ArenaBlock) + capacity;
+        if (!arena_within_budget(self, total)) {
+            // 预算不足时尝试只申请恰好够用的块
+            capacity = size;
+            total = sizeof(ArenaBlock) + capacity;
+            if (!arena_within_budget(self, total)) {
+                return NULL; // 错误：超出内存预算
+            }
+        }
+
+        block = (ArenaBlock *)malloc(total);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = self->head;
+        block->capacity = capacity;
+        block->used = 0;
+        self->head = block;
+        self->reserved += total;
+    }
+
+    void *ptr = block->data + block->used;
+    block->used += size;
+    self->used += size;
+    return ptr;
+}
+
+// 外部内存记账
+static bool arena_charge(Arena *self, long delta) {
+    if (delta > 0 && !arena_within_budget(self, (size_t)delta)) {
+        return false; // 错误：超出内存预算
+    }
+    self->reserved += delta;
+    return true;
+}
+
+// 释放全部内存块
+static void arena_release(Arena *self) {
+    ArenaBlock *block = self->head;
+    while (block != NULL) {
+        ArenaBlock *next = block->next;
+        self->reserved -= sizeof(ArenaBlock) + block->capacity;
+        free(block);
+        block = next;
+    }
+    self->head = NULL;
+    self->used = 0;
+}
+
+// 初始化竞技场分配器
+void arena_init(Arena *self, size_t block_size, size_t budget) {
+    self->head = NULL;
+    self->block_size = block_size > 0 ? block_size : ARENA_DEFAULT_BLOCK_SIZE;
+    self->budget = budget;
+    self->reserved = 0;
+    self->used = 0;
+    self->alloc = arena_alloc;
+    self->charge = arena_charge;
+    self->release = arena_release;
+}
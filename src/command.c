@@ -3,49 +3,370 @@
 #include <stdlib.h>
 #include "command.h"
 #include "pal.h"
+#include "log.h"
+#include "suggest.h"
 
 // 静态全局的命令管理器单例
-static CommandManager command_manager = { .command_count = 0, .alias_count = 0 };
+static CommandManager command_manager = { .initialized = 0 };
 
-// 注册命令到命令管理器
-int command_register_command(CommandManager* self, const char *name, CommandFunction func) {
-    if (self->command_count >= MAX_COMMANDS) {
-        return COMMAND_ERROR_TABLE_FULL; // 错误：命令表已满
+// 初始化分段注册表
+static void registry_init(RegistryTable *table, size_t entry_size) {
+    memset(table, 0, sizeof(*table));
+    table->entry_size = entry_size;
+}
+
+// 获取指定索引处条目的地址
+static void *registry_at(RegistryTable *table, int index) {
+    // 第 k 段起始索引为 BASE * (2^k - 1)
+    int segment = 0;
+    int start = 0;
+    int size = REGISTRY_SEGMENT_BASE;
+    while (index >= start + size) {
+        start += size;
+        size <<= 1;
+        segment++;
+    }
+    return (unsigned char *)table->segments[segment] + (size_t)(index - start) * table->entry_size;
+}
+
+// 追加一个条目，容量不足时在竞技场中分配新段
+static void *registry_append(RegistryTable *table, Arena *arena) {
+    if (table->count >= table->capacity) {
+        if (table->segment_count >= REGISTRY_MAX_SEGMENTS) {
+            return NULL;
+        }
+        int size = REGISTRY_SEGMENT_BASE << table->segment_count;
+        void *segment = arena->alloc(arena, (size_t)size * table->entry_size);
+        if (segment == NULL) {
+            return NULL; // 错误：超出内存预算
+        }
+        table->segments[table->segment_count++] = segment;
+        table->capacity += size;
+    }
+    return registry_at(table, table->count++);
+}
+
+// 首次使用时初始化竞技场、驻留池和注册表
+static void command_ensure_initialized(CommandManager* self) {
+    if (self->initialized) {
+        return;
     }
+    arena_init(&self->arena, COMMAND_ARENA_BLOCK_SIZE, COMMAND_MEMORY_BUDGET);
+    string_pool_init(&self->strings, &self->arena);
+    registry_init(&self->commands, sizeof(Command));
+    registry_init(&self->aliases, sizeof(AliasEntry));
+    self->initialized = 1;
+}
 
-    Command *cmd = &self->command_table[self->command_count++];
-    strncpy(cmd->name, name, sizeof(cmd->name) - 1);
-    cmd->name[sizeof(cmd->name) - 1] = '\0'; // 确保以 '\0' 结尾
+// 注册命令：func 和 handler 只设置其一
+static int command_register(CommandManager* self, const char *name, CommandFunction func,
+                            const CommandSchema *schema, CommandHandler handler) {
+    command_ensure_initialized(self);
+
+    // 先占用表项再驻留名称，表满时不会留下无用的字符串
+    Command *cmd = (Command *)registry_append(&self->commands, &self->arena);
+    if (cmd == NULL) {
+        return COMMAND_ERROR_TABLE_FULL; // 错误：命令表已满
+    }
+    const char *interned = self->strings.intern(&self->strings, name, strlen(name));
+    if (interned == NULL) {
+        self->commands.count--; // 撤销表项
+        return COMMAND_ERROR_TABLE_FULL; // 错误：超出内存预算
+    }
+    cmd->name = interned;
     cmd->function = func;
+    cmd->schema = schema;
+    cmd->handler = handler;
     return COMMAND_SUCCESS; // 成功
 }
 
+// 注册命令到命令管理器
+int command_register_command(CommandManager* self, const char *name, CommandFunction func) {
+    return command_register(self, name, func, NULL, NULL);
+}
+
+// 注册带参数模式的命令，参数模式须在命令存续期间有效（通常为静态常量）
+int command_register_schema_command(CommandManager* self, const char *name, const CommandSchema *schema, CommandHandler handler) {
+    if (schema->size > COMMAND_ARGS_MAX_SIZE || schema->arg_count > COMMAND_MAX_ARG_SPECS) {
+        return COMMAND_ERROR_BAD_SCHEMA; // 错误：分发时无法容纳
+    }
+    return command_register(self, name, NULL, schema, handler);
+}
+
+// 按名字查找选项，未找到返回 -1
+static int schema_find_option(const CommandSchema *schema, const char *name) {
+    for (int i = 0; i < schema->arg_count; i++) {
+        if (schema->args[i].name != NULL && strcmp(schema->args[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 输出参数值的占位文本，如 <0..2>、<a|b>
+static size_t schema_format_value(const CommandArg *arg, char *buffer, size_t size) {
+    if (arg->type == ARG_TYPE_REST) {
+        return snprintf(buffer, size, "<%s...>", arg->value_name ? arg->value_name : "args");
+    }
+    if (arg->value_name != NULL) {
+        return snprintf(buffer, size, "<%s>", arg->value_name);
+    }
+    switch (arg->type) {
+        case ARG_TYPE_INT:
+            return snprintf(buffer, size, "<%d..%d>", arg->min, arg->max);
+        case ARG_TYPE_CHOICE: {
+            size_t length = snprintf(buffer, size, "<");
+            for (int i = 0; arg->choices[i] != NULL && length < size; i++) {
+                length += snprintf(buffer + length, size - length, "%s%s", i > 0 ? "|" : "", arg->choices[i]);
+            }
+            if (length < size) {
+                length += snprintf(buffer + length, size - length, ">");
+            }
+            return length;
+        }
+        default:
+            return snprintf(buffer, size, "<value>");
+    }
+}
+
+// 按参数模式生成用法文本
+int command_format_usage(CommandManager* self, int id, char *buffer, size_t size) {
+    if (!self->initialized || id < 0 || id >= self->commands.count || size == 0) {
+        return -1;
+    }
+    Command *cmd = (Command *)registry_at(&self->commands, id);
+    const CommandSchema *schema = cmd->schema;
+    if (schema == NULL) {
+        return -1;
+    }
+
+    bool one_of = (schema->flags & COMMAND_SCHEMA_ONE_OF) != 0;
+    size_t length = snprintf(buffer, size, "Usage: %s", cmd->name);
+    for (int i = 0; i < schema->arg_count && length < size; i++) {
+        const CommandArg *arg = &schema->args[i];
+        bool optional = !one_of && !(arg->flags & COMMAND_ARG_REQUIRED);
+        char value[48] = "";
+
+        if (arg->type != ARG_TYPE_FLAG) {
+            schema_format_value(arg, value, sizeof(value));
+        }
+        if (one_of && i > 0) {
+            length += snprintf(buffer + length, size - length, " | %s", cmd->name);
+        }
+        if (length < size) {
+            length += snprintf(buffer + length, size - length, " %s%s%s%s%s", optional ? "[" : "",
+                               arg->name ? arg->name : "", arg->name && value[0] ? " " : "", value, optional ? "]" : "");
+        }
+    }
+    return length < size ? (int)length : (int)size - 1;
+}
+
+// 记录参数错误和命令用法
+static void command_reject_args(CommandManager* self, int id, const char *reason) {
+    LogManager *log_manager = get_log_manager();
+    char message[128];
+    snprintf(message, sizeof(message), "%s: %s", ((Command *)registry_at(&self->commands, id))->name, reason);
+    log_manager->log(LOG_LEVEL_ERROR, message);
+    if (command_format_usage(self, id, message, sizeof(message)) > 0) {
+        log_manager->log(LOG_LEVEL_ERROR, message);
+    }
+}
+
+// 解析并校验单个参数值
+static bool schema_parse_value(const CommandArg *arg, const char *text, unsigned char *args, char *reason, size_t size) {
+    const char *label = arg->name ? arg->name : "argument";
+    switch (arg->type) {
+        case ARG_TYPE_INT: {
+            char *end = NULL;
+            long value = strtol(text, &end, 10);
+            if (end == text || *end != '\0' || value < arg->min || value > arg->max) {
+                snprintf(reason, size, "%s: '%s' is not an integer in %d..%d.", label, text, arg->min, arg->max);
+                return false;
+            }
+            *(int *)(args + arg->offset) = (int)value;
+            return true;
+        }
+        case ARG_TYPE_CHOICE:
+            for (int i = 0; arg->choices[i] != NULL; i++) {
+                if (strcmp(arg->choices[i], text) == 0) {
+                    *(int *)(args + arg->offset) = i;
+                    return true;
+                }
+            }
+            snprintf(reason, size, "%s: invalid value '%s'.", label, text);
+            return false;
+        case ARG_TYPE_STRING:
+            *(const char **)(args + arg->offset) = text;
+            return true;
+        default:
+            *(bool *)(args + arg->offset) = true;
+            return true;
+    }
+}
+
+// 按参数模式将 argv 解析到参数结构体，失败时 reason 中为错误描述
+static bool schema_parse(const CommandSchema *schema, int argc, char *argv[], unsigned char *args,
+                         char *reason, size_t size) {
+    unsigned seen = 0;
+    int options = 0;
+    int positional = 0;
+
+    memset(args, 0, schema->size);
+    for (int i = 0; i < schema->arg_count; i++) {
+        const CommandArg *arg = &schema->args[i];
+        if (arg->type == ARG_TYPE_INT || arg->type == ARG_TYPE_CHOICE) {
+            *(int *)(args + arg->offset) = arg->fallback;
+        }
+    }
+
+    for (int i = 1; i < argc; i++) {
+        int index = schema_find_option(schema, argv[i]);
+        if (index < 0) {
+            // 不是已知选项：'-' 开头且不是数字时视为未知选项，否则按顺序匹配位置参数
+            bool number = argv[i][0] == '-' && argv[i][1] >= '0' && argv[i][1] <= '9';
+            if (argv[i][0] == '-' && !number) {
+                snprintf(reason, size, "unknown option '%s'.", argv[i]);
+                return false;
+            }
+            while (positional < schema->arg_count && schema->args[positional].name != NULL) {
+                positional++;
+            }
+            if (positional >= schema->arg_count) {
+                snprintf(reason, size, "unexpected argument '%s'.", argv[i]);
+                return false;
+            }
+            index = positional++;
+            if (schema->args[index].type == ARG_TYPE_REST) {
+                // 其余的词原样交给命令，不再按选项解析
+                CommandRest *rest = (CommandRest *)(args + schema->args[index].offset);
+                rest->argc = argc - i;
+                rest->argv = &argv[i];
+                seen |= 1u << index;
+                break;
+            }
+            if (!schema_parse_value(&schema->args[index], argv[i], args, reason, size)) {
+                return false;
+            }
+        } else {
+            const CommandArg *arg = &schema->args[index];
+            if (seen & (1u << index)) {
+                snprintf(reason, size, "%s given more than once.", arg->name);
+                return false;
+            }
+            options++;
+            if (arg->type != ARG_TYPE_FLAG && ++i >= argc) {
+                snprintf(reason, size, "%s requires a value.", arg->name);
+                return false;
+            }
+            if (!schema_parse_value(arg, argv[i], args, reason, size)) {
+                return false;
+            }
+        }
+        seen |= 1u << index;
+    }
+
+    if ((schema->flags & COMMAND_SCHEMA_ONE_OF) && options != 1) {
+        snprintf(reason, size, "%s", options == 0 ? "missing option." : "options are mutually exclusive.");
+        return false;
+    }
+    for (int i = 0; i < schema->arg_count; i++) {
+        const CommandArg *arg = &schema->args[i];
+        if ((arg->flags & COMMAND_ARG_REQUIRED) && !(seen & (1u << i))) {
+            if (arg->name != NULL) {
+                snprintf(reason, size, "%s is required.", arg->name);
+            } else {
+                snprintf(reason, size, "missing %s.", arg->value_name != NULL ? arg->value_name : "argument");
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 // 注册别名到别名表
 int command_register_alias(CommandManager* self, const char *alias, const char *command_name) {
-    if (self->alias_count >= MAX_ALIASES) {
+    command_ensure_initialized(self);
+
+    // 先占用表项再驻留字符串，表满时不会留下无用的字符串；
+    // 竞技场只追加分配，第二个字符串驻留失败时第一个仍留在池中（再次注册时复用）
+    AliasEntry *entry = (AliasEntry *)registry_append(&self->aliases, &self->arena);
+    if (entry == NULL) {
         return ALIAS_ERROR_TABLE_FULL; // 错误：别名表已满
     }
-
-    AliasEntry *entry = &self->alias_table[self->alias_count++];
-    strncpy(entry->alias, alias, sizeof(entry->alias) - 1);
-    entry->alias[sizeof(entry->alias) - 1] = '\0';
-    strncpy(entry->command_name, command_name, sizeof(entry->command_name) - 1);
-    entry->command_name[sizeof(entry->command_name) - 1] = '\0';
+    const char *interned_alias = self->strings.intern(&self->strings, alias, strlen(alias));
+    const char *interned_name = interned_alias != NULL ?
+        self->strings.intern(&self->strings, command_name, strlen(command_name)) : NULL;
+    if (interned_name == NULL) {
+        self->aliases.count--; // 撤销表项
+        return ALIAS_ERROR_TABLE_FULL; // 错误：超出内存预算
+    }
+    entry->alias = interned_alias;
+    entry->command_name = interned_name;
     return COMMAND_SUCCESS; // 成功
 }
 
-// 查找别名
+// 查找别名（参数为驻留字符串，按指针比较）
 static const char *command_resolve_alias(CommandManager* self, const char *alias) {
-    for (int i = 0; i < self->alias_count; i++) {
-        if (strcmp(self->alias_table[i].alias, alias) == 0) {
-            return self->alias_table[i].command_name;
+    for (int i = 0; i < self->aliases.count; i++) {
+        AliasEntry *entry = (AliasEntry *)registry_at(&self->aliases, i);
+        if (entry->alias == alias) {
+            return entry->command_name;
         }
     }
     return alias; // 如果找不到别名，返回原始命令
 }
 
+// 查找命令或别名对应的编号
+int command_find_command(CommandManager* self, const char *name) {
+    command_ensure_initialized(self);
+
+    // 未驻留的名字一定不是已注册的命令或别名
+    const char *interned = self->strings.find(&self->strings, name, strlen(name));
+    if (interned == NULL) {
+        return COMMAND_ERROR_NOT_FOUND;
+    }
+
+    const char *command_name = command_resolve_alias(self, interned);
+    for (int i = 0; i < self->commands.count; i++) {
+        Command *cmd = (Command *)registry_at(&self->commands, i);
+        if (cmd->name == command_name) {
+            return i;
+        }
+    }
+    return COMMAND_ERROR_NOT_FOUND; // 错误：命令未找到
+}
+
+// 按编号执行命令，编号即命令在注册表中的索引
+int command_execute_by_id(CommandManager* self, int id, int argc, char *argv[]) {
+    if (!self->initialized || id < 0 || id >= self->commands.count) {
+        return COMMAND_ERROR_NOT_FOUND; // 错误：编号超出范围
+    }
+    Command *cmd = (Command *)registry_at(&self->commands, id);
+    if (cmd->schema == NULL) {
+        cmd->function(argc, argv);
+        return COMMAND_SUCCESS; // 成功
+    }
+
+    // 按参数模式解析一次，校验失败时命令不会执行
+    union {
+        void *pointer;
+        long long integer;
+        double number;
+        unsigned char bytes[COMMAND_ARGS_MAX_SIZE];
+    } args;
+    char reason[96];
+    if (!schema_parse(cmd->schema, argc, argv, args.bytes, reason, sizeof(reason))) {
+        command_reject_args(self, id, reason);
+        return COMMAND_ERROR_INVALID_ARGS;
+    }
+    cmd->handler(args.bytes);
+    return COMMAND_SUCCESS; // 成功
+}
+
 // 执行命令
 int command_execute_command(CommandManager* self, const char *input) {
+    command_ensure_initialized(self);
+
     char *argv[MAX_ARGC];
     int argc = 0;
 
@@ -63,37 +384,194 @@ int command_execute_command(CommandManager* self, const char *input) {
         return COMMAND_ERROR_NO_INPUT; // 错误：没有有效命令输入
     }
 
-    const char *command_name = command_resolve_alias(self, argv[0]);
-    for (int i = 0; i < self->command_count; i++) {
-        if (strcmp(self->command_table[i].name, command_name) == 0) {
-            self->command_table[i].function(argc, argv);
-            return COMMAND_SUCCESS; // 成功
-        }
+    int id = command_find_command(self, argv[0]);
+    if (id < 0) {
+        command_report_not_found(argv[0]);
+        return COMMAND_ERROR_NOT_FOUND; // 错误：命令未找到
     }
-
-    return COMMAND_ERROR_NOT_FOUND; // 错误：命令未找到
+    return command_execute_by_id(self, id, argc, argv);
 }
 
 // 获取已注册的命令数
 int command_get_command_count(CommandManager* self) {
-    return self->command_count;
+    return self->initialized ? self->commands.count : 0;
 }
 
 // 获取指定索引处的命令名称
 const char *command_get_command_name(CommandManager* self, int index) {
-    if (index >= 0 && index < self->command_count) {
-        return self->command_table[index].name;
+    if (self->initialized && index >= 0 && index < self->commands.count) {
+        return ((Command *)registry_at(&self->commands, index))->name;
+    }
+    return NULL; // 错误：索引超出范围
+}
+
+// 获取已注册的别名数
+int command_get_alias_count(CommandManager* self) {
+    return self->initialized ? self->aliases.count : 0;
+}
+
+// 获取指定索引处的别名
+const AliasEntry *command_get_alias(CommandManager* self, int index) {
+    if (self->initialized && index >= 0 && index < self->aliases.count) {
+        return (const AliasEntry *)registry_at(&self->aliases, index);
     }
     return NULL; // 错误：索引超出范围
 }
 
+#if SHELL_FEATURE_COMPLETION
+// 按参数模式补全行中最后一个词：前一个词是枚举选项时补全其值，否则补全尚未给出的选项名
+const char *command_complete_argument(CommandManager* self, const char *line, int *word_start) {
+    char *argv[MAX_ARGC];
+    int argc = 0;
+    char input_copy[MAX_INPUT_SIZE];
+    size_t length = strlen(line);
+    if (length >= sizeof(input_copy)) {
+        return NULL;
+    }
+    memcpy(input_copy, line, length + 1);
+
+    for (char *token = strtok(input_copy, " "); token != NULL && argc < MAX_ARGC; token = strtok(NULL, " ")) {
+        argv[argc++] = token;
+    }
+    // 行以空格结尾时补全一个新词
+    bool new_word = length > 0 && line[length - 1] == ' ';
+    if (argc == 0 || (argc == 1 && !new_word)) {
+        return NULL; // 还在输入命令名
+    }
+    const char *partial = new_word ? "" : argv[argc - 1];
+    int previous = new_word ? argc - 1 : argc - 2;
+
+    int id = command_find_command(self, argv[0]);
+    if (id < 0) {
+        return NULL;
+    }
+    const CommandSchema *schema = ((Command *)registry_at(&self->commands, id))->schema;
+    if (schema == NULL) {
+        return NULL;
+    }
+
+    const char *match = NULL;
+    size_t partial_length = strlen(partial);
+    int option = previous > 0 ? schema_find_option(schema, argv[previous]) : -1;
+    if (option >= 0 && schema->args[option].type != ARG_TYPE_FLAG) {
+        const CommandArg *arg = &schema->args[option];
+        if (arg->type != ARG_TYPE_CHOICE) {
+            return NULL; // 需要用户输入的值
+        }
+        for (int i = 0; arg->choices[i] != NULL; i++) {
+            if (strncmp(arg->choices[i], partial, partial_length) == 0) {
+                if (match != NULL) {
+                    return NULL;
+                }
+                match = arg->choices[i];
+            }
+        }
+    } else {
+        // 互斥选项已给出一个时不再补全；进入其余参数（如 watch 的命令）后不再补全
+        int given = 0;
+        int positional = 0;
+        for (int i = 1; i <= previous; i++) {
+            int index = schema_find_option(schema, argv[i]);
+            if (index >= 0) {
+                given++;
+                i += schema->args[index].type != ARG_TYPE_FLAG; // 跳过选项的值
+                continue;
+            }
+            while (positional < schema->arg_count && schema->args[positional].name != NULL) {
+                positional++;
+            }
+            if (positional >= schema->arg_count || schema->args[positional].type == ARG_TYPE_REST) {
+                return NULL;
+            }
+            positional++;
+        }
+        if ((schema->flags & COMMAND_SCHEMA_ONE_OF) && given > 0) {
+            return NULL;
+        }
+        for (int i = 0; i < schema->arg_count; i++) {
+            const char *name = schema->args[i].name;
+            if (name == NULL || strncmp(name, partial, partial_length) != 0) {
+                continue;
+            }
+            bool repeated = false;
+            for (int j = 1; j <= previous; j++) {
+                repeated |= strcmp(argv[j], name) == 0;
+            }
+            if (repeated) {
+                continue;
+            }
+            if (match != NULL) {
+                return NULL;
+            }
+            match = name;
+        }
+    }
+    if (match != NULL) {
+        *word_start = (int)(length - partial_length);
+    }
+    return match;
+}
+#endif // SHELL_FEATURE_COMPLETION
+
+// 设置内存预算
+int command_set_memory_budget(CommandManager* self, size_t budget) {
+    command_ensure_initialized(self);
+    if (budget != 0 && budget < self->arena.reserved) {
+        return COMMAND_ERROR_BUDGET; // 错误：预算小于已申请的内存
+    }
+    self->arena.budget = budget;
+    return COMMAND_SUCCESS;
+}
+
+// 获取注册表内存使用统计
+void command_get_memory_stats(CommandManager* self, CommandMemoryStats *stats) {
+    command_ensure_initialized(self);
+    stats->budget = self->arena.budget;
+    stats->reserved = self->arena.reserved;
+    stats->used = self->arena.used;
+    stats->string_bytes = self->strings.bytes;
+    stats->string_count = (int)self->strings.count;
+    stats->command_capacity = self->commands.capacity;
+    stats->alias_capacity = self->aliases.capacity;
+}
+
+// 记录命令未找到，并附上最接近的已注册命令或别名
+void command_report_not_found(const char *name) {
+    LogManager *log_manager = get_log_manager();
+#if SHELL_FEATURE_SUGGEST
+    SuggestManager *suggest_manager = get_suggest_manager();
+    char hint[96];
+    char message[160];
+
+    if (name[0] != '\0' && suggest_manager->format(suggest_manager, name, hint, sizeof(hint)) > 0) {
+        snprintf(message, sizeof(message), "Command not found: %s. %s", name, hint);
+        log_manager->log(LOG_LEVEL_ERROR, message);
+        return;
+    }
+#endif
+    log_manager->log(LOG_LEVEL_ERROR, "Command not found.");
+}
+
 // 获取单例命令管理器的指针
 CommandManager* get_command_manager() {
     command_manager.register_command = command_register_command;
+    command_manager.register_schema_command = command_register_schema_command;
     command_manager.register_alias = command_register_alias;
     command_manager.execute_command = command_execute_command;
+    command_manager.execute_by_id = command_execute_by_id;
+    command_manager.find_command = command_find_command;
     command_manager.get_command_count = command_get_command_count;
     command_manager.get_command_name = command_get_command_name;
+    command_manager.get_alias_count = command_get_alias_count;
+    command_manager.get_alias = command_get_alias;
+    command_manager.format_usage = command_format_usage;
+#if SHELL_FEATURE_COMPLETION
+    command_manager.complete_argument = command_complete_argument;
+#else
+    command_manager.complete_argument = NULL;
+#endif
+    command_manager.set_memory_budget = command_set_memory_budget;
+    command_manager.get_memory_stats = command_get_memory_stats;
 
     return &command_manager;
 }
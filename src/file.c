@@ -0,0 +1,436 @@
+#include "shell_config.h"
+
+#if defined(__linux__) && SHELL_FEATURE_FILE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include "file.h"
+#include "pal.h"
+#include "output.h"
+#include "log.h"
+
+// 文件数据的处理函数：cat/tail 直接输出，hexdump 格式化
+typedef void (*FileSink)(void *context, const char *data, size_t length);
+
+// hexdump 的格式化状态，文件按窗口送入，不完整的行留到下一次
+typedef struct HexdumpState {
+    unsigned char line[FILE_HEXDUMP_WIDTH];     // 不完整的行
+    size_t line_length;                         // 不完整行的字节数
+    unsigned char previous[FILE_HEXDUMP_WIDTH]; // 上一个输出的整行，用于折叠重复行
+    bool has_previous;                          // previous 是否有效
+    bool squeezing;                             // 已输出 '*'，正在跳过重复行
+    unsigned long long offset;                  // 当前行的文件偏移
+    size_t used;                                // 输出块中已格式化的字节数
+} HexdumpState;
+
+static char file_input[FILE_BUFFER_SIZE];  // read 退回路径和 tail 的读取缓冲区
+static char file_output[FILE_BUFFER_SIZE]; // hexdump 的输出块，整块交给 PAL
+static char hex_pairs[256][2];             // 字节 -> 两位十六进制字符
+static bool hex_ready = false;
+static sigjmp_buf file_bus_jump;           // 访问映射区时文件被截短，SIGBUS 跳回此处
+
+// 记录带文件名的错误日志
+static void file_log_error(const char *command, const char *path, const char *reason) {
+    char message[160];
+    snprintf(message, sizeof(message), "%s: %s: %s", command, path, reason);
+    get_log_manager()->log(LOG_LEVEL_ERROR, message);
+}
+
+// 直接交给 PAL 输出，大块数据不经输出队列复制
+static void file_sink_output(void *context, const char *data, size_t length) {
+    get_pal_interface()->uart_send_buffer(data, length);
+}
+
+// 用 read 将 [start, end) 交给 sink，end 为 -1 时读到文件结束；用于无法映射的文件和 tail -f 的新增内容
+static int file_stream_read(int fd, off_t start, off_t end, FileSink sink, void *context) {
+    if (lseek(fd, start, SEEK_SET) < 0 && errno != ESPIPE) {
+        return -1; // 管道等不可定位的文件从当前位置读
+    }
+    while (end < 0 || start < end) {
+        size_t want = sizeof(file_input);
+        if (end >= 0 && (off_t)want > end - start) {
+            want = (size_t)(end - start);
+        }
+        ssize_t length = read(fd, file_input, want);
+        if (length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (length == 0) {
+            break; // 文件比预期短
+        }
+        sink(context, file_input, (size_t)length);
+        start += length;
+    }
+    return 0;
+}
+
+// 访问映射区时文件已被截短：跳出 sink，放弃本次读取
+static void file_bus_handler(int signo) {
+    siglongjmp(file_bus_jump, 1);
+}
+
+// 将 [start, end) 按窗口映射后直接交给 sink，映射失败时退回 read
+// 映射期间文件被截短时返回 -1（EIO）：sink 访问映射区触发的 SIGBUS 由 file_bus_handler 捕获，
+// 内核代为访问（write 直接写出映射区）时没有信号，由每个窗口之后的 fstat 发现
+static int file_stream_range(int fd, off_t start, off_t end, FileSink sink, void *context) {
+    long page = sysconf(_SC_PAGESIZE);
+    struct sigaction action;
+    struct sigaction saved;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = file_bus_handler;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGBUS, &action, &saved);
+
+    int result = 0;
+    while (start < end) {
+        off_t base = start - start % page;
+        size_t span = end - base < FILE_MAP_WINDOW ? (size_t)(end - base) : FILE_MAP_WINDOW;
+        void *map = mmap(NULL, span, PROT_READ, MAP_PRIVATE, fd, base);
+        if (map == MAP_FAILED) {
+            result = file_stream_read(fd, start, end, sink, context);
+            break;
+        }
+        if (sigsetjmp(file_bus_jump, 1) != 0) {
+            munmap(map, span);
+            errno = EIO;
+            result = -1;
+            break;
+        }
+        madvise(map, span, MADV_SEQUENTIAL);
+        sink(context, (const char *)map + (start - base), span - (size_t)(start - base));
+        munmap(map, span);
+        start = base + (off_t)span;
+
+        // 映射区直接交给 write 时，截短后的页面让 write 返回 EFAULT 而不触发 SIGBUS，
+        // 这一窗口的输出可能已不完整：每个窗口之后检查文件是否变短
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size < end) {
+            errno = EIO;
+            result = -1;
+            break;
+        }
+    }
+    sigaction(SIGBUS, &saved, NULL);
+    return result;
+}
+
+// 打开文件并将全部内容交给 sink；/proc 等大小未知的文件用 read
+static int file_stream(const char *command, const char *path, FileSink sink, void *context) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        file_log_error(command, path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    int result;
+    if (fstat(fd, &st) < 0) {
+        result = -1;
+    } else if (S_ISDIR(st.st_mode)) {
+        errno = EISDIR;
+        result = -1;
+    } else if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        result = file_stream_range(fd, 0, st.st_size, sink, context);
+    } else {
+        result = file_stream_read(fd, 0, -1, sink, context);
+    }
+    if (result < 0) {
+        file_log_error(command, path, strerror(errno));
+    }
+    close(fd);
+    return result;
+}
+
+// cat 命令的参数模式
+static const CommandArg file_cat_args[] = {
+    COMMAND_ARG_REST(FileCatArgs, files, "file"),
+};
+const CommandSchema file_cat_schema = COMMAND_SCHEMA(file_cat_args, FileCatArgs, 0);
+
+// cat 命令实现
+void file_cat_command(const void *args) {
+    const FileCatArgs *options = (const FileCatArgs *)args;
+    for (int i = 0; i < options->files.argc; i++) {
+        file_stream("cat", options->files.argv[i], file_sink_output, NULL);
+    }
+}
+
+// 写出已格式化的输出块
+static void hexdump_flush(HexdumpState *state) {
+    get_pal_interface()->uart_send_buffer(file_output, state->used);
+    state->used = 0;
+}
+
+// 保证输出块中至少还有一行的空间
+static char* hexdump_reserve(HexdumpState *state) {
+    if (state->used + FILE_HEXDUMP_LINE_SIZE > sizeof(file_output)) {
+        hexdump_flush(state);
+    }
+    return file_output + state->used;
+}
+
+// 格式化偏移：4 GiB 以内 8 位，超出时 16 位
+static char* hexdump_put_offset(char *out, unsigned long long offset) {
+    for (int shift = (offset >> 32) ? 56 : 24; shift >= 0; shift -= 8) {
+        memcpy(out, hex_pairs[(offset >> shift) & 0xFF], 2);
+        out += 2;
+    }
+    return out;
+}
+
+// 格式化一行：偏移、十六进制列（第 8 字节后多一个空格）和可打印字符列，每个字节查表一次
+static void hexdump_put_line(HexdumpState *state, const unsigned char *bytes, size_t count) {
+    char *out = hexdump_reserve(state);
+    char *p = hexdump_put_offset(out, state->offset);
+    *p++ = ' ';
+    *p++ = ' ';
+    for (size_t i = 0; i < FILE_HEXDUMP_WIDTH; i++) {
+        if (i < count) {
+            memcpy(p, hex_pairs[bytes[i]], 2);
+        } else {
+            p[0] = ' ';
+            p[1] = ' ';
+        }
+        p[2] = ' ';
+        p += 3;
+        if (i == FILE_HEXDUMP_WIDTH / 2 - 1) {
+            *p++ = ' ';
+        }
+    }
+    *p++ = ' ';
+    *p++ = '|';
+    for (size_t i = 0; i < count; i++) {
+        *p++ = (bytes[i] >= 0x20 && bytes[i] < 0x7F) ? (char)bytes[i] : '.';
+    }
+    *p++ = '|';
+    *p++ = '\n';
+    state->used += (size_t)(p - out);
+}
+
+// 输出一个整行，与上一行相同时折叠为一个 '*'
+static void hexdump_full_line(HexdumpState *state, const unsigned char *bytes) {
+    if (state->has_previous && memcmp(bytes, state->previous, FILE_HEXDUMP_WIDTH) == 0) {
+        if (!state->squeezing) {
+            char *out = hexdump_reserve(state);
+            out[0] = '*';
+            out[1] = '\n';
+            state->used += 2;
+            state->squeezing = true;
+        }
+    } else {
+        hexdump_put_line(state, bytes, FILE_HEXDUMP_WIDTH);
+        memcpy(state->previous, bytes, FILE_HEXDUMP_WIDTH);
+        state->has_previous = true;
+        state->squeezing = false;
+    }
+    state->offset += FILE_HEXDUMP_WIDTH;
+}
+
+// hexdump 的 sink：整行直接从映射区格式化，跨窗口的行先拼接
+static void hexdump_sink(void *context, const char *data, size_t length) {
+    HexdumpState *state = (HexdumpState *)context;
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    while (length > 0) {
+        if (state->line_length == 0 && length >= FILE_HEXDUMP_WIDTH) {
+            hexdump_full_line(state, bytes);
+            bytes += FILE_HEXDUMP_WIDTH;
+            length -= FILE_HEXDUMP_WIDTH;
+            continue;
+        }
+        size_t take = FILE_HEXDUMP_WIDTH - state->line_length;
+        if (take > length) {
+            take = length;
+        }
+        memcpy(state->line + state->line_length, bytes, take);
+        state->line_length += take;
+        bytes += take;
+        length -= take;
+        if (state->line_length == FILE_HEXDUMP_WIDTH) {
+            hexdump_full_line(state, state->line);
+            state->line_length = 0;
+        }
+    }
+}
+
+// hexdump 命令的参数模式
+static const CommandArg file_hexdump_args[] = {
+    COMMAND_ARG_POSITIONAL(FileHexdumpArgs, path, "file"),
+};
+const CommandSchema file_hexdump_schema = COMMAND_SCHEMA(file_hexdump_args, FileHexdumpArgs, 0);
+
+// hexdump 命令实现
+void file_hexdump_command(const void *args) {
+    const FileHexdumpArgs *options = (const FileHexdumpArgs *)args;
+    if (!hex_ready) {
+        static const char digits[] = "0123456789abcdef";
+        for (int i = 0; i < 256; i++) {
+            hex_pairs[i][0] = digits[i >> 4];
+            hex_pairs[i][1] = digits[i & 0x0F];
+        }
+        hex_ready = true;
+    }
+
+    HexdumpState state = { .line_length = 0, .has_previous = false, .squeezing = false, .offset = 0, .used = 0 };
+    file_stream("hexdump", options->path, hexdump_sink, &state);
+
+    // 最后的不完整行和结束偏移
+    if (state.line_length > 0) {
+        hexdump_put_line(&state, state.line, state.line_length);
+        state.offset += state.line_length;
+    }
+    if (state.offset > 0) {
+        char *out = hexdump_reserve(&state);
+        char *p = hexdump_put_offset(out, state.offset);
+        *p++ = '\n';
+        state.used += (size_t)(p - out);
+    }
+    hexdump_flush(&state);
+}
+
+// 从文件末尾向前找出最后 lines 行的起始偏移，末尾的换行不算新的一行
+static off_t tail_find_start(int fd, off_t size, int lines) {
+    off_t position = size;
+    int newlines = 0;
+
+    if (lines <= 0) {
+        return size;
+    }
+    while (position > 0) {
+        size_t chunk = position < (off_t)sizeof(file_input) ? (size_t)position : sizeof(file_input);
+        position -= (off_t)chunk;
+        if (pread(fd, file_input, chunk, position) != (ssize_t)chunk) {
+            return 0; // 读取失败时从头输出
+        }
+        for (size_t i = chunk; i > 0; i--) {
+            if (file_input[i - 1] == '\n' && position + (off_t)i != size && ++newlines == lines) {
+                return position + (off_t)i;
+            }
+        }
+    }
+    return 0;
+}
+
+// tail -f：等待 inotify 事件，文件增长时只读取新增部分，截短时从头开始
+static void tail_follow(const char *path, int fd, off_t offset) {
+    LogManager *log_manager = get_log_manager();
+    OutputManager *output = get_output_manager();
+
+    int notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify < 0 || inotify_add_watch(notify, path, IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF) < 0) {
+        file_log_error("tail", path, strerror(errno));
+        if (notify >= 0) {
+            close(notify);
+        }
+        return;
+    }
+    log_manager->log(LOG_LEVEL_INFO, "Following file, press 'q' to stop.");
+
+    bool quit = false;
+    while (!quit) {
+        output->flush(output);
+
+        // 经输出调度器检查退出键（含暂存的输入），只对 inotify 描述符做短暂等待
+        while (output->has_input(output)) {
+            int ch = output->read_char(output);
+            if (ch == 'q' || ch == 'Q' || ch < 0) {
+                quit = true;
+                break;
+            }
+        }
+        struct pollfd event_fd = { .fd = notify, .events = POLLIN };
+        if (quit || poll(&event_fd, 1, FILE_TAIL_POLL) <= 0 || !(event_fd.revents & POLLIN)) {
+            continue;
+        }
+
+        // 一次读出全部事件，只关心是否有变化以及文件是否已被移走
+        char events[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)]
+            __attribute__((aligned(__alignof__(struct inotify_event))));
+        uint32_t mask = 0;
+        ssize_t length;
+        while ((length = read(notify, events, sizeof(events))) > 0) {
+            for (char *p = events; p < events + length; ) {
+                const struct inotify_event *event = (const struct inotify_event *)p;
+                mask |= event->mask;
+                p += sizeof(struct inotify_event) + event->len;
+            }
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            if (st.st_size < offset) {
+                log_manager->log(LOG_LEVEL_WARN, "tail: file truncated.");
+                offset = 0;
+            }
+            if (st.st_size > offset) {
+                file_stream_read(fd, offset, st.st_size, file_sink_output, NULL);
+                offset = st.st_size;
+            }
+            if (st.st_nlink == 0) {
+                mask |= IN_DELETE_SELF; // 仍持有描述符时删除只产生 IN_ATTRIB
+            }
+        }
+        if (mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+            log_manager->log(LOG_LEVEL_WARN, "tail: file was moved or deleted.");
+            quit = true;
+        }
+    }
+    close(notify);
+}
+
+// tail 命令的参数模式
+static const CommandArg file_tail_args[] = {
+    COMMAND_ARG_INT("-n", FileTailArgs, lines, 0, INT_MAX, FILE_TAIL_DEFAULT_LINES),
+    COMMAND_ARG_FLAG("-f", FileTailArgs, follow),
+    COMMAND_ARG_POSITIONAL(FileTailArgs, path, "file"),
+};
+const CommandSchema file_tail_schema = COMMAND_SCHEMA(file_tail_args, FileTailArgs, 0);
+
+// tail 命令实现
+void file_tail_command(const void *args) {
+    const FileTailArgs *options = (const FileTailArgs *)args;
+    const char *path = options->path;
+    OutputManager *output = get_output_manager();
+    if (options->follow && !output->claim_input(output)) {
+        get_log_manager()->log(LOG_LEVEL_ERROR, "tail: -f needs console input to quit.");
+        return;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        file_log_error("tail", path, strerror(errno));
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        file_log_error("tail", path, "Not a regular file");
+        close(fd);
+        return;
+    }
+
+    // 日志文件随时可能被截短，不映射
+    off_t start = tail_find_start(fd, st.st_size, options->lines);
+    file_stream_read(fd, start, st.st_size, file_sink_output, NULL);
+    if (options->follow) {
+        tail_follow(path, fd, st.st_size);
+    }
+    close(fd);
+}
+
+#endif // __linux__ && SHELL_FEATURE_FILE
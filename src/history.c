@@ -1,3 +1,7 @@
+#include "shell_config.h"
+
+#if SHELL_FEATURE_HISTORY
+
 #include <string.h>
 #include <stdlib.h>
 #include "history.h"
@@ -10,8 +14,81 @@ void history_init(HistoryManager* self) {
     self->total_count = 0;
     self->current_index = -1;
     memset(self->history, 0, sizeof(self->history));
+#if SHELL_FEATURE_HINT
+    self->hint_count = 0;
+    self->hint_weight = 1.0f;
+    self->hint_prefix[0] = '\0';
+    self->hint_position = 0;
+#endif
 }
 
+#if SHELL_FEATURE_HINT
+// 更新提示索引：命令每使用一次得分增加当前权重，权重随命令条数按比例增长，
+// 相当于旧的使用按指数衰减，而不需要每次遍历全部条目重新计算
+static void history_hint_add(HistoryManager* self, const char *command) {
+    int index = 0;
+    while (index < self->hint_count && strncmp(self->hints[index].command, command, COMMAND_LENGTH - 1) != 0) {
+        index++;
+    }
+    if (index == self->hint_count) {
+        // 新命令：索引已满时替换得分最低的最后一条
+        if (self->hint_count < HISTORY_HINT_SIZE) {
+            self->hint_count++;
+        }
+        index = self->hint_count - 1;
+        strncpy(self->hints[index].command, command, COMMAND_LENGTH - 1);
+        self->hints[index].command[COMMAND_LENGTH - 1] = '\0';
+        self->hints[index].score = 0;
+    }
+    self->hints[index].score += self->hint_weight;
+
+    // 得分只增不减，向前移动即可保持有序；得分相同时最近使用的在前
+    HistoryHint hint = self->hints[index];
+    while (index > 0 && self->hints[index - 1].score <= hint.score) {
+        self->hints[index] = self->hints[index - 1];
+        index--;
+    }
+    self->hints[index] = hint;
+
+    // 整体缩放不改变顺序
+    self->hint_weight *= HISTORY_HINT_GROWTH;
+    if (self->hint_weight > HISTORY_HINT_RESCALE) {
+        for (int i = 0; i < self->hint_count; i++) {
+            self->hints[i].score /= HISTORY_HINT_RESCALE;
+        }
+        self->hint_weight /= HISTORY_HINT_RESCALE;
+    }
+
+    // 索引顺序已变，下一次查询从头开始
+    self->hint_prefix[0] = '\0';
+    self->hint_position = 0;
+}
+
+// 查找以 prefix 开头且更长的得分最高的命令
+const char* history_suggest(HistoryManager* self, const char *prefix) {
+    size_t length = strlen(prefix);
+    size_t previous = strlen(self->hint_prefix);
+    if (length >= COMMAND_LENGTH - 1) {
+        return NULL;
+    }
+
+    // 前缀在上一次查询的基础上加长时，之前跳过的条目依然不匹配，从上次命中的位置继续；
+    // 逐字符输入时每条索引最多检查一次
+    int index = 0;
+    if (length >= previous && strncmp(prefix, self->hint_prefix, previous) == 0) {
+        index = self->hint_position;
+    }
+    while (index < self->hint_count &&
+           (strncmp(self->hints[index].command, prefix, length) != 0 || self->hints[index].command[length] == '\0')) {
+        index++;
+    }
+
+    memcpy(self->hint_prefix, prefix, length + 1);
+    self->hint_position = index;
+    return index < self->hint_count ? self->hints[index].command + length : NULL;
+}
+#endif // SHELL_FEATURE_HINT
+
 // 添加命令到历史记录
 int history_add(HistoryManager* self, const char *command) {
     if (command == NULL || strlen(command) == 0) {
@@ -23,6 +100,9 @@ int history_add(HistoryManager* self, const char *command) {
     self->history[self->total_count % HISTORY_SIZE][COMMAND_LENGTH - 1] = '\0'; // 确保以 '\0' 结尾
     self->total_count++;
     self->current_index = self->total_count; // 更新索引指向最新记录
+#if SHELL_FEATURE_HINT
+    history_hint_add(self, command);
+#endif
     return 0; // 添加成功
 }
 
@@ -68,6 +148,11 @@ HistoryManager* get_history_manager() {
     history_manager.add = history_add;
     history_manager.get_previous = history_get_previous;
     history_manager.get_next = history_get_next;
+#if SHELL_FEATURE_HINT
+    history_manager.suggest = history_suggest;
+#endif
 
     return &history_manager;
 }
+
+#endif // SHELL_FEATURE_HISTORY
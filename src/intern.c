@@ -0,0 +1,107 @@
+#include <stdlib.h>
+#include <string.h>
+#include "intern.h"
+
+// FNV-1a 哈希
+static uint32_t intern_hash(const char *str, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 在哈希索引中定位字符串所在槽位（或应插入的空槽）
+static InternSlot *intern_lookup(StringPool *self, const char *str, size_t length, uint32_t hash) {
+    size_t mask = self->capacity - 1;
+    size_t i = hash & mask;
+    while (self->slots[i].str != NULL) {
+        InternSlot *slot = &self->slots[i];
+        if (slot->hash == hash && slot->length == length && memcmp(slot->str, str, length) == 0) {
+            return slot;
+        }
+        i = (i + 1) & mask;
+    }
+    return &self->slots[i];
+}
+
+// 扩容哈希索引，索引内存计入竞技场预算
+static bool intern_grow(StringPool *self) {
+    size_t new_capacity = self->capacity ? self->capacity * 2 : INTERN_INITIAL_CAPACITY;
+    size_t old_bytes = self->capacity * sizeof(InternSlot);
+    size_t new_bytes = new_capacity * sizeof(InternSlot);
+
+    if (!self->arena->charge(self->arena, (long)new_bytes)) {
+        return false; // 错误：超出内存预算
+    }
+    InternSlot *new_slots = (InternSlot *)calloc(new_capacity, sizeof(InternSlot));
+    if (new_slots == NULL) {
+        self->arena->charge(self->arena, -(long)new_bytes);
+        return false;
+    }
+
+    InternSlot *old_slots = self->slots;
+    size_t old_capacity = self->capacity;
+    self->slots = new_slots;
+    self->capacity = new_capacity;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].str != NULL) {
+            *intern_lookup(self, old_slots[i].str, old_slots[i].length, old_slots[i].hash) = old_slots[i];
+        }
+    }
+
+    free(old_slots);
+    self->arena->charge(self->arena, -(long)old_bytes);
+    return true;
+}
+
+// 查找已驻留的字符串
+static const char *intern_find(StringPool *self, const char *str, size_t length) {
+    if (self->capacity == 0) {
+        return NULL;
+    }
+    return intern_lookup(self, str, length, intern_hash(str, length))->str;
+}
+
+// 驻留字符串
+static const char *intern_intern(StringPool *self, const char *str, size_t length) {
+    uint32_t hash = intern_hash(str, length);
+    InternSlot *slot = self->capacity > 0 ? intern_lookup(self, str, length, hash) : NULL;
+    if (slot != NULL && slot->str != NULL) {
+        return slot->str; // 已存在，直接复用，不需要扩容
+    }
+
+    // 负载因子保持在 3/4 以下，扩容后重新定位空槽
+    if ((self->count + 1) * 4 > self->capacity * 3) {
+        if (!intern_grow(self)) {
+            return NULL;
+        }
+        slot = intern_lookup(self, str, length, hash);
+    }
+
+    char *copy = (char *)self->arena->alloc(self->arena, length + 1);
+    if (copy == NULL) {
+        return NULL; // 错误：超出内存预算
+    }
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+
+    slot->str = copy;
+    slot->hash = hash;
+    slot->length = (uint32_t)length;
+    self->count++;
+    self->bytes += length + 1;
+    return copy;
+}
+
+// 初始化字符串驻留池
+void string_pool_init(StringPool *self, Arena *arena) {
+    self->arena = arena;
+    self->slots = NULL;
+    self->capacity = 0;
+    self->count = 0;
+    self->bytes = 0;
+    self->intern = intern_intern;
+    self->find = intern_find;
+}
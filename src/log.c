@@ -1,7 +1,8 @@
 #include <stdio.h>
 #include <string.h>
 #include "log.h"
-#include "pal.h"
+#include "output.h"
+#include "shell_config.h"
 
 // 静态全局的日志管理器单例
 static LogManager log_manager = { .current_level = LOG_LEVEL_INFO };
@@ -16,6 +17,9 @@ static bool log_is_enabled(LogLevel level) {
     return level <= log_manager.current_level;
 }
 
+#if SHELL_FEATURE_LOG_COLOR
+#define LOG_COLOR_RESET "\033[0m"
+
 // 获取日志级别的颜色
 static const char* get_color_code(LogLevel level) {
     switch (level) {
@@ -29,6 +33,14 @@ static const char* get_color_code(LogLevel level) {
             return "\033[0m";   // 默认颜色
     }
 }
+#else
+#define LOG_COLOR_RESET ""
+
+// 裁剪颜色时不输出控制序列
+static const char* get_color_code(LogLevel level) {
+    return "";
+}
+#endif
 
 // 打印日志信息
 static void log_message(LogLevel level, const char *message) {
@@ -52,12 +64,19 @@ static void log_message(LogLevel level, const char *message) {
             prefix = "[UNKNOWN]";
     }
 
-    // 发送带颜色的日志信息到 PAL 层的 UART 或终端
-    PalInterface *pal = get_pal_interface();
-    pal->uart_send(get_color_code(level)); // 设置颜色
-    pal->uart_send(prefix);
-    pal->uart_send(message);
-    pal->uart_send("\033[0m\n"); // 重置颜色
+    // 拼接成一条完整的带颜色日志，交给输出调度器按日志优先级排队
+    OutputManager *output = get_output_manager();
+    char line[LOG_LINE_SIZE];
+    int length = snprintf(line, sizeof(line), "%s%s%s" LOG_COLOR_RESET "\n", get_color_code(level), prefix, message);
+    if (length >= 0 && (size_t)length < sizeof(line)) {
+        output->send(output, OUTPUT_PRIORITY_LOG, line);
+    } else {
+        // 超长日志分段发送
+        output->send(output, OUTPUT_PRIORITY_LOG, get_color_code(level)); // 设置颜色
+        output->send(output, OUTPUT_PRIORITY_LOG, prefix);
+        output->send(output, OUTPUT_PRIORITY_LOG, message);
+        output->send(output, OUTPUT_PRIORITY_LOG, LOG_COLOR_RESET "\n"); // 重置颜色
+    }
 }
 
 // 获取单例日志管理器
@@ -0,0 +1,283 @@
+#include "shell_config.h"
+
+#if defined(__linux__) && SHELL_FEATURE_MODULES
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <dlfcn.h>
+#include "module.h"
+#include "command.h"
+#include "pal.h"
+#include "log.h"
+
+// 静态全局的模块管理器单例
+static ModuleManager module_manager;
+
+// 当前单调时间（秒）
+static double module_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 记录带模块路径的错误日志
+static void module_log_error(const char *path, const char *reason) {
+    char message[192];
+    snprintf(message, sizeof(message), "module: %s: %s", path, reason);
+    get_log_manager()->log(LOG_LEVEL_ERROR, message);
+}
+
+// 加载模块并解析其命令表中清单声明过的命令
+static int module_load(ModuleManager *self, int index) {
+    ModuleEntry *module = &self->modules[index];
+    void *handle = dlopen(module->path, RTLD_NOW | RTLD_LOCAL);
+    if (handle == NULL) {
+        char message[256];
+        snprintf(message, sizeof(message), "module: %s", dlerror()); // dlerror 已包含路径
+        get_log_manager()->log(LOG_LEVEL_ERROR, message);
+        return -1;
+    }
+
+    const int *abi = (const int *)dlsym(handle, SHELL_MODULE_ABI_SYMBOL);
+    const ShellModuleCommand *table = (const ShellModuleCommand *)dlsym(handle, SHELL_MODULE_COMMANDS_SYMBOL);
+    if (abi == NULL || *abi != SHELL_MODULE_ABI || table == NULL) {
+        module_log_error(module->path, "not a shell module or ABI version mismatch");
+        dlclose(handle);
+        return -1;
+    }
+
+    for (int i = 0; i < self->command_count; i++) {
+        ModuleCommand *command = &self->commands[i];
+        if (command->module != index) {
+            continue;
+        }
+        for (const ShellModuleCommand *entry = table; entry->name != NULL; entry++) {
+            if (strcmp(entry->name, command->name) == 0) {
+                command->function = entry->function;
+                break;
+            }
+        }
+    }
+    module->handle = handle;
+    module->loads++;
+    return 0;
+}
+
+// 卸载模块，清空已解析的命令实现
+static void module_unload(ModuleManager *self, int index) {
+    ModuleEntry *module = &self->modules[index];
+    for (int i = 0; i < self->command_count; i++) {
+        if (self->commands[i].module == index) {
+            self->commands[i].function = NULL;
+        }
+    }
+    dlclose(module->handle);
+    module->handle = NULL;
+}
+
+// 模块命令的统一入口：按命令名找到模块，未加载时先加载，再转发调用
+static void module_dispatch(int argc, char *argv[]) {
+    ModuleManager *self = &module_manager;
+    CommandManager *cm = get_command_manager();
+
+    // 命令名已驻留，可以直接比较指针；argv[0] 可能是别名，先解析为命令名
+    const char *name = cm->get_command_name(cm, cm->find_command(cm, argv[0]));
+    ModuleCommand *command = NULL;
+    for (int i = 0; i < self->command_count; i++) {
+        if (self->commands[i].name == name) {
+            command = &self->commands[i];
+            break;
+        }
+    }
+    if (command == NULL) {
+        get_log_manager()->log(LOG_LEVEL_ERROR, "module: command is not provided by any module.");
+        return;
+    }
+
+    ModuleEntry *module = &self->modules[command->module];
+    if (module->handle == NULL && module_load(self, command->module) < 0) {
+        return;
+    }
+    if (command->function == NULL) {
+        module_log_error(module->path, "command listed in the manifest is not exported");
+        return;
+    }
+
+    module->active++;
+    module->calls++;
+    command->function(argc, argv);
+    module->active--;
+    module->last_used = module_now();
+}
+
+// 查找或添加模块，返回下标，模块表已满时返回 -1
+static int module_add(ModuleManager *self, const char *directory, size_t directory_length, const char *path) {
+    char full_path[MODULE_LINE_SIZE];
+    if (path[0] == '/' || directory_length == 0) {
+        snprintf(full_path, sizeof(full_path), "%s", path);
+    } else {
+        snprintf(full_path, sizeof(full_path), "%.*s/%s", (int)directory_length, directory, path);
+    }
+
+    for (int i = 0; i < self->module_count; i++) {
+        if (strcmp(self->modules[i].path, full_path) == 0) {
+            return i;
+        }
+    }
+    if (self->module_count >= MODULE_MAX_MODULES) {
+        return -1;
+    }
+    char *copy = (char *)self->arena.alloc(&self->arena, strlen(full_path) + 1);
+    if (copy == NULL) {
+        return -1;
+    }
+    strcpy(copy, full_path);
+
+    ModuleEntry *module = &self->modules[self->module_count];
+    memset(module, 0, sizeof(*module));
+    module->path = copy;
+    return self->module_count++;
+}
+
+// 注册模块命令：名字交给命令管理器驻留，实现统一指向 module_dispatch
+static int module_register_command(ModuleManager *self, int module, const char *name) {
+    CommandManager *cm = get_command_manager();
+    if (self->command_count >= MODULE_MAX_COMMANDS ||
+        cm->register_command(cm, name, module_dispatch) != COMMAND_SUCCESS) {
+        get_log_manager()->log(LOG_LEVEL_ERROR, "module: command table full.");
+        return -1;
+    }
+
+    ModuleCommand *command = &self->commands[self->command_count++];
+    command->name = cm->get_command_name(cm, cm->find_command(cm, name));
+    command->module = module;
+    command->function = NULL;
+    return 0;
+}
+
+// 读取清单：每行为 "<共享库路径> <命令名...>"，相对路径相对清单所在目录，'#' 之后为注释
+static int module_load_manifest(ModuleManager *self, const char *path) {
+    if (!self->initialized) {
+        arena_init(&self->arena, MODULE_ARENA_BLOCK_SIZE, 0);
+        self->initialized = true;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    const char *slash = strrchr(path, '/');
+    size_t directory_length = slash ? (size_t)(slash - path) : 0;
+
+    char line[MODULE_LINE_SIZE];
+    int registered = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+
+        char *save = NULL;
+        char *library = strtok_r(line, " \t\r\n", &save);
+        if (library == NULL) {
+            continue; // 空行
+        }
+        // 已存在的命令不覆盖；模块至少提供一个新命令时才加入模块表
+        int module = -1;
+        for (char *name = strtok_r(NULL, " \t\r\n", &save); name != NULL; name = strtok_r(NULL, " \t\r\n", &save)) {
+            CommandManager *cm = get_command_manager();
+            if (cm->find_command(cm, name) >= 0) {
+                char message[96];
+                snprintf(message, sizeof(message), "module: command '%s' already exists, skipped.", name);
+                get_log_manager()->log(LOG_LEVEL_WARN, message);
+                continue;
+            }
+            if (module < 0 && (module = module_add(self, path, directory_length, library)) < 0) {
+                module_log_error(library, "module table full");
+                break;
+            }
+            if (module_register_command(self, module, name) == 0) {
+                registered++;
+            }
+        }
+    }
+    fclose(file);
+    return registered;
+}
+
+// 卸载空闲的模块
+static int module_unload_idle(ModuleManager *self, int idle_ms) {
+    double now = module_now();
+    int unloaded = 0;
+    for (int i = 0; i < self->module_count; i++) {
+        ModuleEntry *module = &self->modules[i];
+        if (module->handle != NULL && module->active == 0 && (now - module->last_used) * 1000 >= idle_ms) {
+            module_unload(self, i);
+            unloaded++;
+        }
+    }
+    return unloaded;
+}
+
+// 输出模块列表
+static void module_print(ModuleManager *self) {
+    PalInterface *pal = get_pal_interface();
+    char line[MODULE_LINE_SIZE + 96];
+    double now = module_now();
+
+    for (int i = 0; i < self->module_count; i++) {
+        ModuleEntry *module = &self->modules[i];
+        if (module->handle != NULL) {
+            snprintf(line, sizeof(line), "%s  loaded, idle %.0fs, %lu call(s), %lu load(s)\n",
+                     module->path, now - module->last_used, module->calls, module->loads);
+        } else {
+            snprintf(line, sizeof(line), "%s  not loaded, %lu call(s), %lu load(s)\n",
+                     module->path, module->calls, module->loads);
+        }
+        pal->uart_send(line);
+
+        pal->uart_send("   ");
+        for (int j = 0; j < self->command_count; j++) {
+            if (self->commands[j].module == i) {
+                pal->uart_send(" ");
+                pal->uart_send(self->commands[j].name);
+            }
+        }
+        pal->uart_send("\n");
+    }
+}
+
+// module 命令实现
+void module_command(int argc, char *argv[]) {
+    ModuleManager *self = get_module_manager();
+    LogManager *log_manager = get_log_manager();
+    char message[96];
+
+    if (argc == 1) {
+        self->print(self);
+    } else if (argc == 2 && strcmp(argv[1], "-u") == 0) {
+        snprintf(message, sizeof(message), "Unloaded %d module(s).", self->unload_idle(self, 0));
+        log_manager->log(LOG_LEVEL_INFO, message);
+    } else if (argc == 3 && strcmp(argv[1], "load") == 0) {
+        int registered = self->load_manifest(self, argv[2]);
+        if (registered < 0) {
+            module_log_error(argv[2], "cannot open manifest");
+        } else {
+            snprintf(message, sizeof(message), "Registered %d module command(s).", registered);
+            log_manager->log(LOG_LEVEL_INFO, message);
+        }
+    } else {
+        log_manager->log(LOG_LEVEL_ERROR, "Usage: module | module -u | module load <manifest>");
+    }
+}
+
+// 获取单例模块管理器的指针
+ModuleManager* get_module_manager() {
+    module_manager.load_manifest = module_load_manifest;
+    module_manager.unload_idle = module_unload_idle;
+    module_manager.print = module_print;
+    return &module_manager;
+}
+
+#endif // __linux__ && SHELL_FEATURE_MODULES
@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <string.h>
+#include "output.h"
+#include "pal.h"
+
+// 各优先级队列的存储区
+static char echo_buffer[OUTPUT_ECHO_QUEUE_SIZE];
+static char command_buffer[OUTPUT_COMMAND_QUEUE_SIZE];
+static char log_buffer[OUTPUT_LOG_QUEUE_SIZE];
+
+// 静态全局的输出调度器单例
+static OutputManager output_manager = {
+    .queues = {
+        [OUTPUT_PRIORITY_ECHO] = { .buffer = echo_buffer, .capacity = sizeof(echo_buffer) },
+        [OUTPUT_PRIORITY_COMMAND] = { .buffer = command_buffer, .capacity = sizeof(command_buffer) },
+        [OUTPUT_PRIORITY_LOG] = { .buffer = log_buffer, .capacity = sizeof(log_buffer) },
+    },
+    .paused = false,
+};
+
+// 将数据追加到队列，调用者需保证空间足够
+static void queue_push(OutputQueue *queue, const char *data, size_t length) {
+    size_t tail = (queue->head + queue->length) % queue->capacity;
+    size_t first = queue->capacity - tail;
+    if (first > length) {
+        first = length;
+    }
+    memcpy(queue->buffer + tail, data, first);
+    memcpy(queue->buffer, data + first, length - first);
+    queue->length += length;
+}
+
+// 从队列写出最多 limit 字节到 PAL
+static void queue_drain(OutputQueue *queue, size_t limit) {
+    PalInterface *pal = get_pal_interface();
+    if (limit > queue->length) {
+        limit = queue->length;
+    }
+    while (limit > 0) {
+        size_t chunk = queue->capacity - queue->head;
+        if (chunk > limit) {
+            chunk = limit;
+        }
+        pal->uart_write(queue->buffer + queue->head, chunk);
+        queue->head = (queue->head + chunk) % queue->capacity;
+        queue->length -= chunk;
+        limit -= chunk;
+    }
+}
+
+// 处理流控字符，返回 true 表示该字符已被消费
+static bool output_handle_flow(OutputManager *self, int ch) {
+    if (ch == OUTPUT_XOFF) {
+        self->paused = true;
+        self->stats.xoff_count++;
+        return true;
+    }
+    if (ch == OUTPUT_XON) {
+        self->paused = false;
+        return true;
+    }
+    return false;
+}
+
+// 流控暂停时阻塞等待 XON，期间收到的普通字符暂存起来
+static void output_wait_for_xon(OutputManager *self) {
+    PalInterface *pal = get_pal_interface();
+    while (self->paused) {
+        int ch = pal->get_char();
+        if (ch < 0) {
+            self->paused = false; // 输入已关闭，不再等待
+        } else if (!output_handle_flow(self, ch) && self->pushback_count < OUTPUT_PUSHBACK_SIZE) {
+            self->pushback[self->pushback_count++] = ch;
+        }
+    }
+}
+
+// 读取已到达的输入，消费其中的流控字符，其余暂存；用于长时间连续输出期间及时响应 XOFF
+static void output_poll_flow(OutputManager *self) {
+    PalInterface *pal = get_pal_interface();
+    while (self->pushback_count < OUTPUT_PUSHBACK_SIZE && pal->is_key_pressed()) {
+        int ch = pal->get_char();
+        if (ch < 0) {
+            break;
+        }
+        if (!output_handle_flow(self, ch)) {
+            self->pushback[self->pushback_count++] = ch;
+        }
+    }
+}
+
+// 补充重复和丢弃提示
+static void output_log_notices(OutputManager *self) {
+    OutputQueue *queue = &self->queues[OUTPUT_PRIORITY_LOG];
+    char notice[96];
+
+    if (self->repeat_count > 0) {
+        snprintf(notice, sizeof(notice), "[LOG] Last message repeated %lu time(s).\n", self->repeat_count);
+        if (queue->capacity - queue->length < strlen(notice)) {
+            return; // 空间不足，稍后再提示
+        }
+        queue_push(queue, notice, strlen(notice));
+        self->repeat_count = 0;
+        self->last_log[0] = '\0';
+    }
+    if (self->pending_drops > 0) {
+        snprintf(notice, sizeof(notice), "[LOG] %lu message(s) dropped.\n", self->pending_drops);
+        if (queue->capacity - queue->length < strlen(notice)) {
+            return;
+        }
+        queue_push(queue, notice, strlen(notice));
+        self->pending_drops = 0;
+    }
+}
+
+// 写出回显和命令输出队列
+static void output_flush_interactive(OutputManager *self) {
+    if (self->paused) {
+        return;
+    }
+    queue_drain(&self->queues[OUTPUT_PRIORITY_ECHO], (size_t)-1);
+    queue_drain(&self->queues[OUTPUT_PRIORITY_COMMAND], (size_t)-1);
+}
+
+// 写出全部排队内容
+static void output_flush(OutputManager *self) {
+    output_flush_interactive(self);
+    if (self->paused) {
+        return;
+    }
+    OutputQueue *queue = &self->queues[OUTPUT_PRIORITY_LOG];
+    queue_drain(queue, (size_t)-1);
+    output_log_notices(self);
+    queue_drain(queue, (size_t)-1);
+}
+
+// 排队日志：重复消息合并，队列满时整条丢弃
+static void output_send_log(OutputManager *self, const char *str, size_t length) {
+    OutputQueue *queue = &self->queues[OUTPUT_PRIORITY_LOG];
+
+    if (queue->length > 0 && length < sizeof(self->last_log) &&
+        memcmp(self->last_log, str, length) == 0 && self->last_log[length] == '\0') {
+        self->repeat_count++;
+        self->stats.coalesced_messages++;
+        return;
+    }
+    if (self->repeat_count > 0) {
+        output_log_notices(self);
+    }
+    if (queue->capacity - queue->length < length) {
+        self->stats.dropped_messages++;
+        self->stats.dropped_bytes += length;
+        self->pending_drops++;
+        return;
+    }
+
+    queue_push(queue, str, length);
+    if (length < sizeof(self->last_log)) {
+        memcpy(self->last_log, str, length);
+        self->last_log[length] = '\0';
+    } else {
+        self->last_log[0] = '\0';
+    }
+}
+
+// 大块命令输出：先写出已排队的内容保证顺序，再直接从调用者的缓冲区分块写出，不经队列复制
+static void output_send_direct(OutputManager *self, const char *data, size_t length) {
+    PalInterface *pal = get_pal_interface();
+    while (length > 0) {
+        output_poll_flow(self);
+        output_wait_for_xon(self);
+        output_flush_interactive(self);
+        size_t chunk = length < OUTPUT_DIRECT_CHUNK ? length : OUTPUT_DIRECT_CHUNK;
+        pal->uart_write(data, chunk);
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+// 直接写出一段数据：后续输入可能属于主机的下一帧，这里只等待已收到的 XOFF 解除，不主动读取输入
+static void output_write_direct(OutputManager *self, const char *data, size_t length) {
+    output_wait_for_xon(self);
+    output_flush_interactive(self);
+    get_pal_interface()->uart_write(data, length);
+}
+
+// 按优先级发送一段数据（可含 '\0'）
+static void output_send_buffer(OutputManager *self, OutputPriority priority, const char *str, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    if (self->capture != NULL && priority != OUTPUT_PRIORITY_ECHO) {
+        self->capture(self->capture_context, priority, str, length);
+        return;
+    }
+    if (priority == OUTPUT_PRIORITY_LOG) {
+        output_send_log(self, str, length);
+        return;
+    }
+
+    // 回显和命令输出不丢弃：队列满时先写出，流控暂停时等待 XON（反压）
+    OutputQueue *queue = &self->queues[priority];
+    if (priority == OUTPUT_PRIORITY_COMMAND && length >= queue->capacity) {
+        output_send_direct(self, str, length);
+        return;
+    }
+    while (length > 0) {
+        size_t space = queue->capacity - queue->length;
+        if (space == 0) {
+            output_wait_for_xon(self);
+            output_flush_interactive(self);
+            continue;
+        }
+        size_t chunk = length < space ? length : space;
+        queue_push(queue, str, chunk);
+        str += chunk;
+        length -= chunk;
+    }
+    output_flush_interactive(self);
+}
+
+// 按优先级发送字符串
+static void output_send(OutputManager *self, OutputPriority priority, const char *str) {
+    output_send_buffer(self, priority, str, strlen(str));
+}
+
+// 空闲时写出日志，有按键等待时立即让出给回显
+static void output_service(OutputManager *self) {
+    PalInterface *pal = get_pal_interface();
+    OutputQueue *queue = &self->queues[OUTPUT_PRIORITY_LOG];
+
+    output_flush_interactive(self);
+    while (!self->paused && self->pushback_count == 0 && !pal->is_key_pressed()) {
+        if (queue->length == 0) {
+            if (self->repeat_count == 0 && self->pending_drops == 0) {
+                break;
+            }
+            output_log_notices(self);
+        }
+        queue_drain(queue, OUTPUT_DRAIN_CHUNK);
+    }
+}
+
+// 读取一个输入字符，不处理 XON/XOFF
+static int output_read_raw(OutputManager *self) {
+    if (self->pushback_count > 0) {
+        int ch = self->pushback[0];
+        self->pushback_count--;
+        memmove(self->pushback, self->pushback + 1, self->pushback_count * sizeof(int));
+        return ch;
+    }
+    return get_pal_interface()->get_char();
+}
+
+// 读取一个输入字符，透明处理 XON/XOFF
+static int output_read_char(OutputManager *self) {
+    if (self->pushback_count > 0) {
+        return output_read_raw(self);
+    }
+
+    PalInterface *pal = get_pal_interface();
+    while (true) {
+        int ch = pal->get_char();
+        if (!output_handle_flow(self, ch)) {
+            return ch;
+        }
+        if (!self->paused) {
+            output_flush_interactive(self); // 收到 XON，补发积压的交互输出
+        }
+    }
+}
+
+// 是否有待读取的输入（含暂存的字符）
+static bool output_has_input(OutputManager *self) {
+    return self->pushback_count > 0 || get_pal_interface()->is_key_pressed();
+}
+
+// 命令申请读取按键
+static bool output_claim_input(OutputManager *self) {
+    if (self->input_detached) {
+        self->input_refused = true;
+        return false;
+    }
+    return true;
+}
+
+// 设置输出捕获回调
+static void output_set_capture(OutputManager *self, OutputCaptureFunction func, void *context) {
+    self->capture = func;
+    self->capture_context = context;
+}
+
+// 获取统计信息
+static void output_get_stats(OutputManager *self, OutputStats *stats) {
+    *stats = self->stats;
+}
+
+// 获取单例输出调度器的指针
+OutputManager* get_output_manager() {
+    output_manager.send = output_send;
+    output_manager.send_buffer = output_send_buffer;
+    output_manager.write_direct = output_write_direct;
+    output_manager.flush = output_flush;
+    output_manager.service = output_service;
+    output_manager.read_char = output_read_char;
+    output_manager.read_raw = output_read_raw;
+    output_manager.has_input = output_has_input;
+    output_manager.claim_input = output_claim_input;
+    output_manager.set_capture = output_set_capture;
+    output_manager.get_stats = output_get_stats;
+    return &output_manager;
+}
@@ -1,40 +1,93 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <termios.h>
 #include <unistd.h>
+#include <poll.h>
 #include <string.h>
+#include <errno.h>
 #include "pal.h"
+#include "output.h"
+
+// 进入 shell 前的终端设置，退出时恢复
+static struct termios saved_termios;
+static bool termios_saved = false;
+
+// 恢复原始终端设置
+static void posix_restore_terminal() {
+    if (termios_saved) {
+#if SHELL_FEATURE_PASTE
+        fputs("\033[?2004l", stdout); // 关闭括号粘贴
+        fflush(stdout);
+#endif
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+    }
+}
 
 // POSIX 平台的初始化函数，输出初始化信息
+// - 一次性切换到非规范模式：禁用缓冲（ICANON）、回显（ECHO）、终端自身的 XON/XOFF 处理（IXON）
+//   和回车转换（ICRNL），使流控字符交由输出调度器处理，二进制 RPC 帧原样到达
+// - 终端支持时开启括号粘贴，退出时关闭
 static void posix_init() {
+    if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved_termios) == 0) {
+        struct termios raw = saved_termios;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_iflag &= ~(IXON | ICRNL);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+        termios_saved = true;
+        atexit(posix_restore_terminal);
+#if SHELL_FEATURE_PASTE
+        // 开启括号粘贴：终端把粘贴内容包在 ESC[200~ 和 ESC[201~ 之间
+        printf("\033[?2004h");
+#endif
+    }
     printf("Platform: POSIX Initialized.\n");
+    fflush(stdout);
 }
 
 // POSIX 平台上从标准输入读取一个字符
-// - 使用 termios 修改终端模式以禁用回显和缓冲，读取单个字符
 static int posix_get_char() {
-    struct termios oldt, newt;
-    int ch;
-
-    // 获取当前终端设置并备份
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-
-    // 设置新终端模式：禁用缓冲（ICANON）和回显（ECHO）
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-
-    // 读取单个字符
-    ch = getchar();
-
-    // 恢复原始终端设置
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
+    unsigned char ch;
+    if (read(STDIN_FILENO, &ch, 1) != 1) {
+        return -1; // 输入结束或出错
+    }
     return ch;
 }
 
+// 检查标准输入是否有待读取的数据
+static bool posix_is_key_pressed() {
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+    return poll(&pfd, 1, 0) > 0;
+}
+
 // POSIX 平台上的串口发送实现
-// - 在终端上打印输出字符串
+// - 命令输出交给输出调度器，按优先级排队写出
 static void posix_uart_send(const char *str) {
-    printf("%s", str);
+    OutputManager *output = get_output_manager();
+    output->send(output, OUTPUT_PRIORITY_COMMAND, str);
+}
+
+// POSIX 平台上发送一段命令输出
+static void posix_uart_send_buffer(const char *data, size_t length) {
+    OutputManager *output = get_output_manager();
+    output->send_buffer(output, OUTPUT_PRIORITY_COMMAND, data, length);
+}
+
+// POSIX 平台上的串口直接写出
+// - 直接 write 到标准输出，不经 stdio 缓冲再复制一次
+static void posix_uart_write(const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(STDOUT_FILENO, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return; // 输出已关闭
+        }
+        data += written;
+        length -= (size_t)written;
+    }
 }
 
 // POSIX 平台的延时函数
@@ -47,7 +100,10 @@ static void posix_delay(int ms) {
 static PalInterface pal = {
     .init = posix_init,
     .get_char = posix_get_char,
+    .is_key_pressed = posix_is_key_pressed,
     .uart_send = posix_uart_send,
+    .uart_send_buffer = posix_uart_send_buffer,
+    .uart_write = posix_uart_write,
     .delay = posix_delay,
 };
 
@@ -0,0 +1,387 @@
+#include "shell_config.h"
+
+#if defined(__linux__) && SHELL_FEATURE_PROC
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "proc.h"
+#include "pal.h"
+#include "log.h"
+#include "watch.h"
+
+// 采样器单例（任务表较大，静态分配）
+static ProcSampler proc_sampler;
+
+// 当前单调时间（秒）
+static double proc_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 解析十进制整数（允许负号），返回解析结束位置
+static const char *proc_parse_number(const char *p, long long *value) {
+    bool negative = false;
+    long long result = 0;
+    while (*p == ' ') {
+        p++;
+    }
+    if (*p == '-') {
+        negative = true;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        result = result * 10 + (*p++ - '0');
+    }
+    *value = negative ? -result : result;
+    return p;
+}
+
+// 跳过 n 个以空格分隔的字段
+static const char *proc_skip_fields(const char *p, int n) {
+    while (n-- > 0) {
+        while (*p == ' ') {
+            p++;
+        }
+        while (*p != ' ' && *p != '\0') {
+            p++;
+        }
+    }
+    return p;
+}
+
+// 解析 /proc/<pid>/task/<tid>/stat，字段含义见 proc(5)
+static bool proc_parse_stat(ProcTask *task, const char *buffer) {
+    // comm 可能包含空格和括号，以最后一个 ')' 为界
+    const char *open = strchr(buffer, '(');
+    const char *close = strrchr(buffer, ')');
+    if (open == NULL || close == NULL || close < open) {
+        return false;
+    }
+    size_t length = (size_t)(close - open - 1);
+    if (length >= PROC_NAME_SIZE) {
+        length = PROC_NAME_SIZE - 1;
+    }
+    memcpy(task->name, open + 1, length);
+    task->name[length] = '\0';
+
+    // ')' 之后依次为 state(3) ... utime(14) stime(15) ... nice(19) ... starttime(22)
+    const char *p = close + 2;
+    task->state = *p;
+    long long utime, stime, nice, start_time;
+    p = proc_skip_fields(p, 11);
+    p = proc_parse_number(p, &utime);
+    p = proc_parse_number(p, &stime);
+    p = proc_skip_fields(p, 3);
+    p = proc_parse_number(p, &nice);
+    p = proc_skip_fields(p, 2);
+    proc_parse_number(p, &start_time);
+    task->nice = (int)nice;
+
+    // 启动时间变化说明 tid 已被新任务复用，按新任务处理
+    if ((unsigned long long)start_time != task->start_time) {
+        task->fresh = true;
+        task->start_time = (unsigned long long)start_time;
+    }
+
+    unsigned long long ticks = (unsigned long long)(utime + stime);
+    task->delta = (!task->fresh && ticks >= task->ticks) ? ticks - task->ticks : 0;
+    task->fresh = false;
+    task->ticks = ticks;
+    return true;
+}
+
+// 计算可缓存的描述符上限：RLIMIT_NOFILE 减去余量，给 cat、tail、source 和模块留出描述符
+static int proc_fd_limit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return 0;
+    }
+    if (limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur >= (rlim_t)PROC_MAX_TASKS + PROC_FD_HEADROOM) {
+        return PROC_MAX_TASKS;
+    }
+    return limit.rlim_cur > PROC_FD_HEADROOM ? (int)(limit.rlim_cur - PROC_FD_HEADROOM) : 0;
+}
+
+// 关闭任务描述符
+static void proc_close_task(ProcSampler *self, ProcTask *task) {
+    if (task->fd >= 0) {
+        close(task->fd);
+        task->fd = -1;
+        self->open_fds--;
+    }
+}
+
+// 读取任务的 stat 文件：优先复用已缓存的描述符；周期刷新期间未达上限时打开后保留
+static bool proc_read_task(ProcSampler *self, ProcTask *task) {
+    int fd = task->fd;
+    if (fd < 0) {
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/%d/task/%d/stat", task->pid, task->tid);
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EMFILE || errno == ENFILE) {
+                self->fd_limit = self->open_fds; // 之后不再多占描述符
+            }
+            return false;
+        }
+        if (self->persistent && self->open_fds < self->fd_limit) {
+            task->fd = fd;
+            self->open_fds++;
+        }
+    }
+    ssize_t length = pread(fd, self->buffer, sizeof(self->buffer) - 1, 0);
+    if (fd != task->fd) {
+        close(fd);
+    }
+    if (length <= 0) {
+        return false; // 任务已退出
+    }
+    self->buffer[length] = '\0';
+    return proc_parse_stat(task, self->buffer);
+}
+
+// 在哈希索引中查找 tid，返回槽位
+static int *proc_hash_slot(ProcSampler *self, int tid) {
+    unsigned int i = ((unsigned int)tid * 2654435761u) & (PROC_HASH_SIZE - 1);
+    while (self->hash[i] != 0 && self->tasks[self->hash[i] - 1].tid != tid) {
+        i = (i + 1) & (PROC_HASH_SIZE - 1);
+    }
+    return &self->hash[i];
+}
+
+// 新增任务，描述符在首次读取时按需打开
+static void proc_add_task(ProcSampler *self, int pid, int tid) {
+    if (self->task_count >= PROC_MAX_TASKS) {
+        return;
+    }
+    ProcTask *task = &self->tasks[self->task_count++];
+    memset(task, 0, sizeof(*task));
+    task->pid = pid;
+    task->tid = tid;
+    task->fd = -1;
+    task->generation = self->generation;
+    task->fresh = true;
+    *proc_hash_slot(self, tid) = self->task_count;
+}
+
+// 判断目录名是否为数字
+static bool proc_is_numeric(const char *name) {
+    if (*name == '\0') {
+        return false;
+    }
+    for (; *name; name++) {
+        if (!isdigit((unsigned char)*name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 扫描 /proc 发现新任务，并关闭已消失任务的描述符
+static bool proc_rescan(ProcSampler *self) {
+    self->generation++;
+    DIR *proc = opendir("/proc");
+    if (proc == NULL) {
+        return false;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(proc)) != NULL) {
+        if (!proc_is_numeric(entry->d_name)) {
+            continue;
+        }
+        int pid = atoi(entry->d_name);
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/%d/task", pid);
+        DIR *tasks = opendir(path);
+        if (tasks == NULL) {
+            continue;
+        }
+        struct dirent *task_entry;
+        while ((task_entry = readdir(tasks)) != NULL) {
+            if (!proc_is_numeric(task_entry->d_name)) {
+                continue;
+            }
+            int tid = atoi(task_entry->d_name);
+            int slot = *proc_hash_slot(self, tid);
+            if (slot != 0) {
+                self->tasks[slot - 1].generation = self->generation;
+            } else {
+                proc_add_task(self, pid, tid);
+            }
+        }
+        closedir(tasks);
+    }
+    closedir(proc);
+
+    // 压缩任务表并重建索引
+    int count = 0;
+    for (int i = 0; i < self->task_count; i++) {
+        if (self->tasks[i].generation != self->generation) {
+            proc_close_task(self, &self->tasks[i]);
+            continue;
+        }
+        self->tasks[count++] = self->tasks[i];
+    }
+    self->task_count = count;
+    memset(self->hash, 0, sizeof(self->hash));
+    for (int i = 0; i < count; i++) {
+        *proc_hash_slot(self, self->tasks[i].tid) = i + 1;
+    }
+    return true;
+}
+
+// 采样一次：读取全部任务的 stat，计算与上一次采样之间的 CPU 增量
+static int proc_sample(ProcSampler *self) {
+    if (self->samples % PROC_RESCAN_SAMPLES == 0 && !proc_rescan(self)) {
+        return -1;
+    }
+    if (self->fd_limit == 0) {
+        self->fd_limit = proc_fd_limit();
+    }
+
+    double now = proc_now();
+    self->elapsed_ticks = self->samples > 0 ? (now - self->last_time) * sysconf(_SC_CLK_TCK) : 0;
+    self->last_time = now;
+
+    for (int i = 0; i < self->task_count; i++) {
+        ProcTask *task = &self->tasks[i];
+        if (!proc_read_task(self, task)) {
+            // 任务已退出，下次扫描时移除
+            proc_close_task(self, task);
+            task->generation = 0;
+            task->delta = 0;
+            task->state = 'X';
+        }
+    }
+    self->samples++;
+    return self->task_count;
+}
+
+// 关闭全部缓存的描述符
+static void proc_release(ProcSampler *self) {
+    for (int i = 0; i < self->task_count; i++) {
+        proc_close_task(self, &self->tasks[i]);
+    }
+}
+
+// 排序比较函数使用的采样器
+static ProcSampler *proc_sort_target;
+
+static int proc_compare_cpu(const void *a, const void *b) {
+    const ProcTask *x = &proc_sort_target->tasks[*(const int *)a];
+    const ProcTask *y = &proc_sort_target->tasks[*(const int *)b];
+    if (x->delta != y->delta) {
+        return x->delta < y->delta ? 1 : -1;
+    }
+    return x->tid - y->tid;
+}
+
+static int proc_compare_pid(const void *a, const void *b) {
+    const ProcTask *x = &proc_sort_target->tasks[*(const int *)a];
+    const ProcTask *y = &proc_sort_target->tasks[*(const int *)b];
+    return x->pid != y->pid ? x->pid - y->pid : x->tid - y->tid;
+}
+
+static int proc_compare_name(const void *a, const void *b) {
+    const ProcTask *x = &proc_sort_target->tasks[*(const int *)a];
+    const ProcTask *y = &proc_sort_target->tasks[*(const int *)b];
+    int result = strcmp(x->name, y->name);
+    return result != 0 ? result : x->tid - y->tid;
+}
+
+// 按排序方式输出前 limit 个任务
+static void proc_print(ProcSampler *self, ProcSortKey key, int limit) {
+    PalInterface *pal = get_pal_interface();
+    char line[96];
+    int count = 0;
+
+    for (int i = 0; i < self->task_count; i++) {
+        if (self->tasks[i].state != 'X') {
+            self->order[count++] = i;
+        }
+    }
+    proc_sort_target = self;
+    qsort(self->order, count, sizeof(int),
+          key == PROC_SORT_PID ? proc_compare_pid : key == PROC_SORT_NAME ? proc_compare_name : proc_compare_cpu);
+
+    snprintf(line, sizeof(line), "Tasks: %d, sample #%lu\n", count, self->samples);
+    pal->uart_send(line);
+    pal->uart_send("    PID     TID S  NI   CPU%      TIME NAME\n");
+
+    long ticks_per_second = sysconf(_SC_CLK_TCK);
+    for (int i = 0; i < count && i < limit; i++) {
+        const ProcTask *task = &self->tasks[self->order[i]];
+        double cpu = self->elapsed_ticks > 0 ? 100.0 * task->delta / self->elapsed_ticks : 0.0;
+        unsigned long long seconds = task->ticks / ticks_per_second;
+        snprintf(line, sizeof(line), "%7d %7d %c %3d %6.1f %6llu:%02llu %s\n",
+                 task->pid, task->tid, task->state, task->nice, cpu, seconds / 60, seconds % 60, task->name);
+        pal->uart_send(line);
+    }
+}
+
+// ps 命令的参数模式，排序方式的候选值与 ProcSortKey 顺序一致
+static const char *const proc_sort_names[] = { "cpu", "pid", "name", NULL };
+static const CommandArg proc_ps_args[] = {
+    COMMAND_ARG_CHOICE("-s", ProcPsArgs, sort, proc_sort_names, PROC_SORT_CPU),
+    COMMAND_ARG_INT("-n", ProcPsArgs, limit, 1, PROC_MAX_TASKS, PROC_DEFAULT_LIMIT),
+    COMMAND_ARG_INT("-w", ProcPsArgs, refresh, 1, WATCH_MAX_INTERVAL, 0),
+};
+const CommandSchema proc_ps_schema = COMMAND_SCHEMA(proc_ps_args, ProcPsArgs, 0);
+
+// ps 命令的 Linux 实现
+void proc_ps_command(const void *args) {
+    const ProcPsArgs *options = (const ProcPsArgs *)args;
+    LogManager *log_manager = get_log_manager();
+
+    // 周期刷新交给 watch，只重绘变化的部分
+    if (options->refresh > 0) {
+#if SHELL_FEATURE_WATCH
+        char command[64];
+        snprintf(command, sizeof(command), "ps -s %s -n %d", proc_sort_names[options->sort], options->limit);
+        char *watch_argv[] = { command };
+        WatchArgs watch = { .interval = options->refresh, .command = { 1, watch_argv } };
+        ProcSampler *sampler = get_proc_sampler();
+        sampler->persistent = true; // 刷新期间缓存描述符
+        watch_command(&watch);
+        sampler->persistent = false;
+        sampler->release(sampler);
+#else
+        log_manager->log(LOG_LEVEL_ERROR, "ps -w is not available: watch support is compiled out.");
+#endif
+        return;
+    }
+
+    // 首次调用时先取一次基准，短暂间隔后再采样，保证 CPU 占用有意义
+    ProcSampler *sampler = get_proc_sampler();
+    if (sampler->samples == 0 && sampler->sample(sampler) >= 0) {
+        get_pal_interface()->delay(PROC_BASELINE_DELAY);
+    }
+    if (sampler->sample(sampler) < 0) {
+        log_manager->log(LOG_LEVEL_ERROR, "Failed to read /proc.");
+        return;
+    }
+    sampler->print(sampler, (ProcSortKey)options->sort, options->limit);
+    if (!sampler->persistent) {
+        sampler->release(sampler); // 单次 ps 不占用描述符
+    }
+}
+
+// 获取单例 /proc 采样器的指针
+ProcSampler* get_proc_sampler() {
+    proc_sampler.sample = proc_sample;
+    proc_sampler.print = proc_print;
+    proc_sampler.release = proc_release;
+    return &proc_sampler;
+}
+
+#endif // __linux__ && SHELL_FEATURE_PROC
@@ -0,0 +1,285 @@
+#include "shell_config.h"
+
+#if SHELL_FEATURE_RPC
+
+#include <string.h>
+#include "rpc.h"
+#include "command.h"
+#include "output.h"
+#include "pal.h"
+
+// 静态全局的 RPC 管理器单例
+static RpcManager rpc_manager = { .frames_received = 0, .frames_rejected = 0 };
+
+// CRC-16/CCITT-FALSE 半字节查找表
+static const uint16_t crc16_nibble_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+// 计算 CRC-16/CCITT-FALSE（初值 0xFFFF）
+uint16_t rpc_crc16(uint16_t crc, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble_table[((crc >> 12) ^ (data[i] >> 4)) & 0x0F]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble_table[((crc >> 12) ^ (data[i] & 0x0F)) & 0x0F]);
+    }
+    return crc;
+}
+
+// 发送一帧应答
+static void rpc_send_frame(uint8_t type, uint16_t request_id, const uint8_t *payload, size_t length) {
+    uint8_t header[RPC_HEADER_SIZE] = {
+        RPC_SYNC0, RPC_SYNC1, type,
+        (uint8_t)(request_id & 0xFF), (uint8_t)(request_id >> 8),
+        (uint8_t)(length & 0xFF), (uint8_t)(length >> 8),
+    };
+    uint16_t crc = rpc_crc16(0xFFFF, header + 2, RPC_HEADER_SIZE - 2);
+    crc = rpc_crc16(crc, payload, length);
+    uint8_t trailer[2] = { (uint8_t)(crc & 0xFF), (uint8_t)(crc >> 8) };
+
+    // 经输出调度器写出，主机发送 XOFF 后应答等待 XON
+    OutputManager *output = get_output_manager();
+    output->write_direct(output, (const char *)header, sizeof(header));
+    if (length > 0) {
+        output->write_direct(output, (const char *)payload, length);
+    }
+    output->write_direct(output, (const char *)trailer, sizeof(trailer));
+}
+
+// 发送状态应答
+static void rpc_send_status(uint16_t request_id, int status) {
+    uint8_t payload[2] = { (uint8_t)(status & 0xFF), (uint8_t)((status >> 8) & 0xFF) };
+    rpc_send_frame(RPC_RSP_STATUS, request_id, payload, sizeof(payload));
+}
+
+// 发送缓冲区中的数据
+static void rpc_buffer_flush(RpcManager *self, RpcBuffer *buffer) {
+    if (buffer->length > 0) {
+        rpc_send_frame(buffer->type, self->request_id, buffer->data, buffer->length);
+        buffer->length = 0;
+    }
+}
+
+// 追加数据到缓冲区，攒满一帧即发送
+static void rpc_buffer_append(RpcManager *self, RpcBuffer *buffer, const uint8_t *data, size_t length) {
+    while (length > 0) {
+        size_t chunk = RPC_MAX_PAYLOAD - buffer->length;
+        if (chunk > length) {
+            chunk = length;
+        }
+        memcpy(buffer->data + buffer->length, data, chunk);
+        buffer->length += chunk;
+        data += chunk;
+        length -= chunk;
+        if (buffer->length == RPC_MAX_PAYLOAD) {
+            rpc_buffer_flush(self, buffer);
+        }
+    }
+}
+
+// 输出捕获回调：命令执行期间的输出和日志转为应答帧，日志去掉 ANSI 颜色码
+static void rpc_capture(void *context, OutputPriority priority, const char *data, size_t length) {
+    RpcManager *self = (RpcManager *)context;
+    if (priority != OUTPUT_PRIORITY_LOG) {
+        rpc_buffer_append(self, &self->output, (const uint8_t *)data, length);
+        return;
+    }
+
+    size_t start = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] == '\033' && i + 1 < length && data[i + 1] == '[') {
+            rpc_buffer_append(self, &self->log, (const uint8_t *)data + start, i - start);
+            while (i < length && data[i] != 'm') {
+                i++;
+            }
+            start = i + 1;
+        }
+    }
+    if (start < length) {
+        rpc_buffer_append(self, &self->log, (const uint8_t *)data + start, length - start);
+    }
+}
+
+// 处理 LIST 请求
+static int rpc_handle_list(RpcManager *self) {
+    CommandManager *cm = get_command_manager();
+    for (int i = 0; i < cm->get_command_count(cm); i++) {
+        const char *name = cm->get_command_name(cm, i);
+        size_t length = strlen(name);
+        if (length > 255) {
+            length = 255;
+        }
+        uint8_t entry[3] = { (uint8_t)(i & 0xFF), (uint8_t)(i >> 8), (uint8_t)length };
+        // 条目不跨帧，便于主机逐帧解析
+        if (self->output.length + sizeof(entry) + length > RPC_MAX_PAYLOAD) {
+            rpc_buffer_flush(self, &self->output);
+        }
+        rpc_buffer_append(self, &self->output, entry, sizeof(entry));
+        rpc_buffer_append(self, &self->output, (const uint8_t *)name, length);
+    }
+    return RPC_STATUS_OK;
+}
+
+// 处理 CALL 请求：参数已由主机拆分，直接按编号调用命令
+static int rpc_handle_call(RpcManager *self, uint8_t *payload, size_t length) {
+    if (length < 3) {
+        return RPC_STATUS_BAD_REQUEST;
+    }
+    CommandManager *cm = get_command_manager();
+    int id = payload[0] | (payload[1] << 8);
+    int extra = payload[2];
+    const char *name = cm->get_command_name(cm, id);
+    if (name == NULL) {
+        return COMMAND_ERROR_NOT_FOUND;
+    }
+    if (extra + 1 > RPC_MAX_ARGS) {
+        return RPC_STATUS_BAD_REQUEST;
+    }
+
+    // 参数以 '\0' 分隔，直接指向帧缓冲区，不做复制
+    char *argv[RPC_MAX_ARGS];
+    int argc = 0;
+    argv[argc++] = (char *)name;
+    size_t offset = 3;
+    while (argc < extra + 1) {
+        uint8_t *end = offset < length ? memchr(payload + offset, '\0', length - offset) : NULL;
+        if (end == NULL) {
+            return RPC_STATUS_BAD_REQUEST;
+        }
+        argv[argc++] = (char *)payload + offset;
+        offset = (size_t)(end - payload) + 1;
+    }
+
+    // 链路上后续的字节属于主机的下一帧，命令不能把它们当作按键读取
+    OutputManager *output = get_output_manager();
+    output->set_capture(output, rpc_capture, self);
+    output->input_detached = true;
+    output->input_refused = false;
+    int result = cm->execute_by_id(cm, id, argc, argv);
+    output->input_detached = false;
+    output->set_capture(output, NULL, NULL);
+    return output->input_refused ? RPC_STATUS_NEEDS_INPUT : result;
+}
+
+// 读取帧内的一个字节：超过 RPC_BYTE_TIMEOUT 毫秒没有数据时返回 RPC_READ_TIMEOUT，输入结束时返回 -1
+// 帧内的 0x11/0x13 是数据而不是流控字符，经输出调度器读取原始字节（含等待 XON 时暂存的字节）
+#define RPC_READ_TIMEOUT -2
+static int rpc_read_byte(PalInterface *pal) {
+    OutputManager *output = get_output_manager();
+    for (int waited = 0; !output->has_input(output); waited++) {
+        if (waited >= RPC_BYTE_TIMEOUT) {
+            return RPC_READ_TIMEOUT;
+        }
+        pal->delay(1);
+    }
+    return output->read_raw(output);
+}
+
+// 读取一帧的其余部分并校验，first_byte 为已读取的 SYNC0
+// 返回 0 表示帧有效；返回 1 表示帧已丢弃，应重新寻找同步字节；返回 -1 表示不是帧、超时或输入结束
+static int rpc_read_frame(RpcManager *self, PalInterface *pal, int first_byte,
+                          uint8_t *header, uint8_t *payload, size_t *length) {
+    uint8_t trailer[2];
+
+    header[0] = (uint8_t)first_byte;
+    for (int i = 1; i < RPC_HEADER_SIZE; i++) {
+        int ch = rpc_read_byte(pal);
+        if (ch < 0) {
+            self->frames_rejected += ch == RPC_READ_TIMEOUT;
+            return -1; // 超时或输入结束
+        }
+        header[i] = (uint8_t)ch;
+        if (i == 1 && header[1] != RPC_SYNC1) {
+            self->frames_rejected++; // 不是帧起始，丢弃
+            return -1;
+        }
+    }
+
+    uint16_t request_id = header[3] | (header[4] << 8);
+    *length = header[5] | (header[6] << 8);
+    if (*length > RPC_MAX_PAYLOAD) {
+        self->frames_rejected++;
+        rpc_send_status(request_id, RPC_STATUS_BAD_FRAME);
+        return 1;
+    }
+
+    // 读取 payload 和 CRC
+    for (size_t i = 0; i < *length + sizeof(trailer); i++) {
+        int ch = rpc_read_byte(pal);
+        if (ch < 0) {
+            self->frames_rejected += ch == RPC_READ_TIMEOUT;
+            return -1;
+        }
+        if (i < *length) {
+            payload[i] = (uint8_t)ch;
+        } else {
+            trailer[i - *length] = (uint8_t)ch;
+        }
+    }
+
+    uint16_t crc = rpc_crc16(0xFFFF, header + 2, RPC_HEADER_SIZE - 2);
+    crc = rpc_crc16(crc, payload, *length);
+    if (crc != (trailer[0] | (trailer[1] << 8))) {
+        self->frames_rejected++;
+        rpc_send_status(request_id, RPC_STATUS_BAD_CRC);
+        return 1;
+    }
+    return 0;
+}
+
+// 读取并处理一帧请求
+static void rpc_handle_frame(RpcManager *self, int first_byte) {
+    PalInterface *pal = get_pal_interface();
+    uint8_t header[RPC_HEADER_SIZE];
+    uint8_t payload[RPC_MAX_PAYLOAD];
+    size_t length = 0;
+
+    int result = rpc_read_frame(self, pal, first_byte, header, payload, &length);
+    while (result > 0) {
+        // 坏帧之后跳过字节直到下一个同步字节；线路空闲时回到控制台
+        int ch;
+        do {
+            ch = rpc_read_byte(pal);
+        } while (ch >= 0 && ch != RPC_SYNC0);
+        if (ch < 0) {
+            return;
+        }
+        result = rpc_read_frame(self, pal, ch, header, payload, &length);
+    }
+    if (result < 0) {
+        return;
+    }
+
+    uint16_t request_id = header[3] | (header[4] << 8);
+    self->frames_received++;
+    self->request_id = request_id;
+    int status;
+    switch (header[2]) {
+        case RPC_REQ_PING:
+            status = RPC_STATUS_OK;
+            break;
+        case RPC_REQ_LIST:
+            status = rpc_handle_list(self);
+            break;
+        case RPC_REQ_CALL:
+            status = rpc_handle_call(self, payload, length);
+            break;
+        default:
+            status = RPC_STATUS_BAD_REQUEST;
+            break;
+    }
+
+    rpc_buffer_flush(self, &self->output);
+    rpc_buffer_flush(self, &self->log);
+    rpc_send_status(request_id, status);
+}
+
+// 获取单例 RPC 管理器的指针
+RpcManager* get_rpc_manager() {
+    rpc_manager.output.type = RPC_RSP_DATA;
+    rpc_manager.log.type = RPC_RSP_LOG;
+    rpc_manager.handle_frame = rpc_handle_frame;
+    return &rpc_manager;
+}
+
+#endif // SHELL_FEATURE_RPC
@@ -0,0 +1,969 @@
+#include "shell_config.h"
+
+#if SHELL_FEATURE_SCRIPT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include "script.h"
+#include "command.h"
+#include "pal.h"
+
+// 命令编号的特殊取值：运行时再解析；内置命令编码为 SCRIPT_BUILTIN_BASE - 下标
+#define SCRIPT_COMMAND_DYNAMIC -1
+#define SCRIPT_BUILTIN_BASE -2
+
+// 词法单元类型
+typedef enum {
+    TOKEN_WORD,        // 单词
+    TOKEN_SEPARATOR,   // ; 或换行
+    TOKEN_AND,         // &&
+    TOKEN_OR,          // ||
+    TOKEN_END          // 源码结束
+} ScriptToken;
+
+// 编译器工作区，编译完成后按实际大小打包进 CompiledScript
+typedef struct ScriptCompiler {
+    ScriptManager *manager;
+    const char *source;
+    size_t length;
+    size_t pos;
+    ScriptToken token;                       // 当前词法单元
+    uint16_t token_word;                     // 当前单词的下标
+    ScriptInstr instrs[SCRIPT_MAX_INSTRS];
+    int instr_count;
+    ScriptWord words[SCRIPT_MAX_WORDS];
+    int word_count;
+    char pool[SCRIPT_MAX_SOURCE * 2];        // 转义后最多翻倍
+    size_t pool_size;
+    int loop_depth;                          // 当前 for 循环嵌套深度
+    int failure;                             // 编译失败时的错误码
+} ScriptCompiler;
+
+typedef int (*ScriptBuiltin)(ScriptManager *self, int argc, char *argv[]);
+
+typedef struct ScriptBuiltinEntry {
+    const char *name;          // 名称，NULL 表示只能由语法生成（赋值）
+    ScriptBuiltin function;
+} ScriptBuiltinEntry;
+
+// 静态全局的脚本解释器单例与编译器工作区
+static ScriptManager script_manager = { .clock = 0, .variable_count = 0 };
+static ScriptCompiler compiler;
+
+// ========== 变量 ==========
+
+// 检查字符串是否为合法变量名
+static bool script_is_identifier(const char *name, size_t length) {
+    if (length == 0 || length >= SCRIPT_NAME_SIZE || !(isalpha((unsigned char)name[0]) || name[0] == '_')) {
+        return false;
+    }
+    for (size_t i = 1; i < length; i++) {
+        if (!(isalnum((unsigned char)name[i]) || name[i] == '_')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 按名称查找变量
+static ScriptVariable *script_find_variable(ScriptManager *self, const char *name, size_t length) {
+    for (int i = 0; i < self->variable_count; i++) {
+        if (strncmp(self->variables[i].name, name, length) == 0 && self->variables[i].name[length] == '\0') {
+            return &self->variables[i];
+        }
+    }
+    return NULL;
+}
+
+// 读取变量
+static const char *script_get_variable(ScriptManager *self, const char *name) {
+    ScriptVariable *var = script_find_variable(self, name, strlen(name));
+    return var ? var->value : NULL;
+}
+
+// 设置变量
+static int script_set_variable(ScriptManager *self, const char *name, const char *value) {
+    size_t length = strlen(name);
+    if (!script_is_identifier(name, length)) {
+        return -1; // 错误：变量名不合法
+    }
+    ScriptVariable *var = script_find_variable(self, name, length);
+    if (var == NULL) {
+        if (self->variable_count >= SCRIPT_MAX_VARIABLES) {
+            return -1; // 错误：变量表已满
+        }
+        var = &self->variables[self->variable_count++];
+        memcpy(var->name, name, length + 1);
+    }
+    strncpy(var->value, value, sizeof(var->value) - 1);
+    var->value[sizeof(var->value) - 1] = '\0';
+    return 0;
+}
+
+// ========== 内置命令 ==========
+
+// set：无参数时列出变量，否则 set NAME VALUE...
+static int builtin_set(ScriptManager *self, int argc, char *argv[]) {
+    PalInterface *pal = get_pal_interface();
+    if (argc == 1) {
+        for (int i = 0; i < self->variable_count; i++) {
+            pal->uart_send(self->variables[i].name);
+            pal->uart_send("=");
+            pal->uart_send(self->variables[i].value);
+            pal->uart_send("\n");
+        }
+        return 0;
+    }
+
+    char value[SCRIPT_VALUE_SIZE] = "";
+    size_t used = 0;
+    for (int i = 2; i < argc && used < sizeof(value); i++) {
+        used += snprintf(value + used, sizeof(value) - used, "%s%s", i > 2 ? " " : "", argv[i]);
+    }
+    return script_set_variable(self, argv[1], value) == 0 ? 0 : 1;
+}
+
+// NAME=VALUE 赋值
+static int builtin_assign(ScriptManager *self, int argc, char *argv[]) {
+    return script_set_variable(self, argv[0], argc > 1 ? argv[1] : "") == 0 ? 0 : 1;
+}
+
+// unset NAME...
+static int builtin_unset(ScriptManager *self, int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        ScriptVariable *var = script_find_variable(self, argv[i], strlen(argv[i]));
+        if (var != NULL) {
+            *var = self->variables[--self->variable_count];
+        }
+    }
+    return 0;
+}
+
+// echo ARGS...
+static int builtin_echo(ScriptManager *self, int argc, char *argv[]) {
+    PalInterface *pal = get_pal_interface();
+    for (int i = 1; i < argc; i++) {
+        if (i > 1) {
+            pal->uart_send(" ");
+        }
+        pal->uart_send(argv[i]);
+    }
+    pal->uart_send("\n");
+    return 0;
+}
+
+// true / false
+static int builtin_true(ScriptManager *self, int argc, char *argv[]) {
+    return 0;
+}
+
+static int builtin_false(ScriptManager *self, int argc, char *argv[]) {
+    return 1;
+}
+
+// test EXPR / [ EXPR ]：支持 -z -n = != -eq -ne -lt -le -gt -ge 和 ! 取反
+static int builtin_test(ScriptManager *self, int argc, char *argv[]) {
+    if (strcmp(argv[0], "[") == 0) {
+        if (argc < 2 || strcmp(argv[argc - 1], "]") != 0) {
+            return 2; // 错误：缺少 ]
+        }
+        argc--;
+    }
+
+    char **args = argv + 1;
+    int count = argc - 1;
+    bool negate = false;
+    if (count > 0 && strcmp(args[0], "!") == 0) {
+        negate = true;
+        args++;
+        count--;
+    }
+
+    bool result;
+    if (count == 0) {
+        result = false;
+    } else if (count == 1) {
+        result = args[0][0] != '\0';
+    } else if (count == 2 && strcmp(args[0], "-z") == 0) {
+        result = args[1][0] == '\0';
+    } else if (count == 2 && strcmp(args[0], "-n") == 0) {
+        result = args[1][0] != '\0';
+    } else if (count == 3 && strcmp(args[1], "=") == 0) {
+        result = strcmp(args[0], args[2]) == 0;
+    } else if (count == 3 && strcmp(args[1], "!=") == 0) {
+        result = strcmp(args[0], args[2]) != 0;
+    } else if (count == 3) {
+        long a = strtol(args[0], NULL, 10);
+        long b = strtol(args[2], NULL, 10);
+        if (strcmp(args[1], "-eq") == 0) {
+            result = a == b;
+        } else if (strcmp(args[1], "-ne") == 0) {
+            result = a != b;
+        } else if (strcmp(args[1], "-lt") == 0) {
+            result = a < b;
+        } else if (strcmp(args[1], "-le") == 0) {
+            result = a <= b;
+        } else if (strcmp(args[1], "-gt") == 0) {
+            result = a > b;
+        } else if (strcmp(args[1], "-ge") == 0) {
+            result = a >= b;
+        } else {
+            return 2; // 错误：未知运算符
+        }
+    } else {
+        return 2; // 错误：表达式格式不正确
+    }
+    return (result != negate) ? 0 : 1;
+}
+
+// let NAME A [op B]：整数运算，op 为 + - * / %
+static int builtin_let(ScriptManager *self, int argc, char *argv[]) {
+    if (argc != 3 && argc != 5) {
+        return 2;
+    }
+    long result = strtol(argv[2], NULL, 10);
+    if (argc == 5) {
+        long b = strtol(argv[4], NULL, 10);
+        switch (argv[3][0]) {
+            case '+': result += b; break;
+            case '-': result -= b; break;
+            case '*': result *= b; break;
+            case '/':
+            case '%':
+                if (b == 0) {
+                    return 2; // 错误：除数为 0
+                }
+                result = argv[3][0] == '/' ? result / b : result % b;
+                break;
+            default:
+                return 2;
+        }
+    }
+    char value[24];
+    snprintf(value, sizeof(value), "%ld", result);
+    return script_set_variable(self, argv[1], value) == 0 ? 0 : 1;
+}
+
+// 内置命令表，编号为 SCRIPT_BUILTIN_BASE - 下标
+static const ScriptBuiltinEntry builtins[] = {
+    { NULL, builtin_assign },
+    { "set", builtin_set },
+    { "unset", builtin_unset },
+    { "echo", builtin_echo },
+    { "true", builtin_true },
+    { "false", builtin_false },
+    { "test", builtin_test },
+    { "[", builtin_test },
+    { "let", builtin_let },
+};
+#define SCRIPT_BUILTIN_COUNT ((int)(sizeof(builtins) / sizeof(builtins[0])))
+#define SCRIPT_BUILTIN_ASSIGN SCRIPT_BUILTIN_BASE
+#define SCRIPT_BUILTIN_TRUE (SCRIPT_BUILTIN_BASE - 4)
+
+// 按名称查找内置命令
+static int script_find_builtin(const char *name, size_t length) {
+    for (int i = 0; i < SCRIPT_BUILTIN_COUNT; i++) {
+        if (builtins[i].name != NULL && strlen(builtins[i].name) == length &&
+            memcmp(builtins[i].name, name, length) == 0) {
+            return SCRIPT_BUILTIN_BASE - i;
+        }
+    }
+    return SCRIPT_COMMAND_DYNAMIC;
+}
+
+// ========== 编译器 ==========
+
+// 记录编译错误（只保留第一个）
+static void compile_error(ScriptCompiler *c, int code, const char *message, const char *detail) {
+    if (c->failure == 0) {
+        c->failure = code;
+        snprintf(c->manager->error, sizeof(c->manager->error), "%s%s", message, detail ? detail : "");
+    }
+}
+
+// 向字符池追加一个字符
+static void pool_push(ScriptCompiler *c, char ch) {
+    if (c->pool_size >= sizeof(c->pool)) {
+        compile_error(c, SCRIPT_ERROR_TOO_LARGE, "Script too large.", NULL);
+        return;
+    }
+    c->pool[c->pool_size++] = ch;
+}
+
+// 追加字面字符，'$' 和 '\' 转义以便与变量引用区分
+static void pool_push_literal(ScriptCompiler *c, char ch) {
+    if (ch == '$' || ch == '\\') {
+        pool_push(c, '\\');
+    }
+    pool_push(c, ch);
+}
+
+// 新增一个单词
+static int add_word(ScriptCompiler *c, size_t offset, size_t length, bool expand) {
+    if (c->word_count >= SCRIPT_MAX_WORDS) {
+        compile_error(c, SCRIPT_ERROR_TOO_LARGE, "Script has too many words.", NULL);
+        return 0;
+    }
+    ScriptWord *word = &c->words[c->word_count];
+    word->offset = (uint16_t)offset;
+    word->length = (uint16_t)length;
+    word->expand = expand;
+    return c->word_count++;
+}
+
+// 扫描一个单词，处理引号、反斜杠和 '$'
+static void scan_word(ScriptCompiler *c) {
+    size_t start = c->pool_size;
+    bool expand = false;
+
+    while (c->pos < c->length && c->failure == 0) {
+        char ch = c->source[c->pos];
+        if (strchr(" \t\r\n;&|", ch) != NULL) {
+            break;
+        }
+        c->pos++;
+        if (ch == '\'') {
+            while (c->pos < c->length && c->source[c->pos] != '\'') {
+                pool_push_literal(c, c->source[c->pos++]);
+            }
+            if (c->pos >= c->length) {
+                compile_error(c, SCRIPT_ERROR_SYNTAX, "Syntax error: unterminated quote.", NULL);
+                return;
+            }
+            c->pos++;
+        } else if (ch == '"') {
+            while (c->pos < c->length && c->source[c->pos] != '"') {
+                char inner = c->source[c->pos++];
+                if (inner == '\\' && c->pos < c->length && strchr("\"\\$", c->source[c->pos]) != NULL) {
+                    pool_push_literal(c, c->source[c->pos++]);
+                } else if (inner == '$') {
+                    pool_push(c, '$');
+                    expand = true;
+                } else {
+                    pool_push_literal(c, inner);
+                }
+            }
+            if (c->pos >= c->length) {
+                compile_error(c, SCRIPT_ERROR_SYNTAX, "Syntax error: unterminated quote.", NULL);
+                return;
+            }
+            c->pos++;
+        } else if (ch == '\\') {
+            if (c->pos < c->length) {
+                pool_push_literal(c, c->source[c->pos++]);
+            }
+        } else if (ch == '$') {
+            pool_push(c, '$');
+            expand = true;
+        } else {
+            pool_push_literal(c, ch);
+        }
+    }
+
+    // 不需要展开的单词去掉转义，运行时直接复制
+    if (!expand) {
+        size_t out = start;
+        for (size_t i = start; i < c->pool_size; i++) {
+            if (c->pool[i] == '\\') {
+                i++;
+            }
+            c->pool[out++] = c->pool[i];
+        }
+        c->pool_size = out;
+    }
+    c->token_word = (uint16_t)add_word(c, start, c->pool_size - start, expand);
+}
+
+// 读取下一个词法单元
+static void scan(ScriptCompiler *c) {
+    while (c->pos < c->length) {
+        char ch = c->source[c->pos];
+        if (ch == ' ' || ch == '\t' || ch == '\r') {
+            c->pos++;
+        } else if (ch == '#') {
+            while (c->pos < c->length && c->source[c->pos] != '\n') {
+                c->pos++; // 注释
+            }
+        } else {
+            break;
+        }
+    }
+
+    if (c->pos >= c->length || c->failure != 0) {
+        c->token = TOKEN_END;
+        return;
+    }
+
+    char ch = c->source[c->pos];
+    char next = c->pos + 1 < c->length ? c->source[c->pos + 1] : '\0';
+    if (ch == ';' || ch == '\n') {
+        c->token = TOKEN_SEPARATOR;
+        c->pos++;
+    } else if (ch == '&' || ch == '|') {
+        if (next != ch) {
+            compile_error(c, SCRIPT_ERROR_SYNTAX, ch == '&' ? "Syntax error: unexpected '&'." : "Syntax error: pipes are not supported.", NULL);
+            c->token = TOKEN_END;
+            return;
+        }
+        c->token = ch == '&' ? TOKEN_AND : TOKEN_OR;
+        c->pos += 2;
+    } else {
+        c->token = TOKEN_WORD;
+        scan_word(c);
+    }
+}
+
+// 当前单词是否为指定关键字
+static bool token_is(ScriptCompiler *c, const char *keyword) {
+    if (c->token != TOKEN_WORD) {
+        return false;
+    }
+    const ScriptWord *word = &c->words[c->token_word];
+    return !word->expand && word->length == strlen(keyword) &&
+           memcmp(c->pool + word->offset, keyword, word->length) == 0;
+}
+
+// 当前单词是否为结束语句块的关键字
+static bool token_is_terminator(ScriptCompiler *c) {
+    return token_is(c, "then") || token_is(c, "else") || token_is(c, "elif") ||
+           token_is(c, "fi") || token_is(c, "do") || token_is(c, "done");
+}
+
+// 生成一条指令，返回其下标
+static int emit(ScriptCompiler *c, ScriptOpcode op) {
+    if (c->instr_count >= SCRIPT_MAX_INSTRS) {
+        compile_error(c, SCRIPT_ERROR_TOO_LARGE, "Script has too many instructions.", NULL);
+        return 0;
+    }
+    ScriptInstr *instr = &c->instrs[c->instr_count];
+    memset(instr, 0, sizeof(*instr));
+    instr->op = op;
+    return c->instr_count++;
+}
+
+// 回填跳转目标为当前位置
+static void patch(ScriptCompiler *c, int instr) {
+    c->instrs[instr].target = (uint16_t)c->instr_count;
+}
+
+// 生成把状态置为 0 的指令
+static void emit_true(ScriptCompiler *c) {
+    int instr = emit(c, SCRIPT_OP_EXEC);
+    c->instrs[instr].command = SCRIPT_BUILTIN_TRUE;
+}
+
+// 要求当前单词为指定关键字并跳过
+static void expect(ScriptCompiler *c, const char *keyword) {
+    if (!token_is(c, keyword)) {
+        compile_error(c, SCRIPT_ERROR_SYNTAX, "Syntax error: expected ", keyword);
+        return;
+    }
+    scan(c);
+}
+
+static void parse_list(ScriptCompiler *c);
+
+// 简单命令：连续的单词，编译期尽量解析出命令编号
+static void parse_simple(ScriptCompiler *c) {
+    int first = c->token_word;
+    int argc = 0;
+    while (c->token == TOKEN_WORD && c->failure == 0) {
+        argc++;
+        scan(c);
+    }
+    if (argc > MAX_ARGC) {
+        compile_error(c, SCRIPT_ERROR_SYNTAX, "Syntax error: too many arguments.", NULL);
+        return;
+    }
+
+    int instr = emit(c, SCRIPT_OP_EXEC);
+    const ScriptWord *word = &c->words[first];
+    const char *text = c->pool + word->offset;
+    const char *equals = memchr(text, '=', word->length);
+
+    if (argc == 1 && equals != NULL && script_is_identifier(text, (size_t)(equals - text))) {
+        // NAME=VALUE：拆成名字和值两个单词
+        size_t name_length = (size_t)(equals - text);
+        int name = add_word(c, word->offset, name_length, false);
+        add_word(c, word->offset + name_length + 1, word->length - name_length - 1, c->words[first].expand);
+        c->instrs[instr].word = (uint16_t)name;
+        c->instrs[instr].argc = 2;
+        c->instrs[instr].command = SCRIPT_BUILTIN_ASSIGN;
+        return;
+    }
+
+    c->instrs[instr].word = (uint16_t)first;
+    c->instrs[instr].argc = (uint8_t)argc;
+    c->instrs[instr].command = SCRIPT_COMMAND_DYNAMIC;
+    if (!word->expand) {
+        int builtin = script_find_builtin(text, word->length);
+        if (builtin != SCRIPT_COMMAND_DYNAMIC) {
+            c->instrs[instr].command = (int16_t)builtin;
+        } else {
+            char name[MAX_INPUT_SIZE];
+            size_t length = word->length < sizeof(name) - 1 ? word->length : sizeof(name) - 1;
+            memcpy(name, text, length);
+            name[length] = '\0';
+            CommandManager *cm = get_command_manager();
+            int id = cm->find_command(cm, name);
+            if (id >= 0) {
+                c->instrs[instr].command = (int16_t)id; // 未找到的命令留到运行时再解析
+            }
+        }
+    }
+}
+
+// if LIST then LIST [elif LIST then LIST]... [else LIST] fi
+static void parse_if(ScriptCompiler *c) {
+    int end_jumps[SCRIPT_MAX_INSTRS / 4];
+    int end_count = 0;
+
+    scan(c); // 跳过 if/elif
+    while (true) {
+        parse_list(c);
+        expect(c, "then");
+        int skip = emit(c, SCRIPT_OP_JUMP_IF_FAIL);
+        parse_list(c);
+        if (c->failure != 0) {
+            return;
+        }
+        if (end_count == (int)(sizeof(end_jumps) / sizeof(end_jumps[0]))) {
+            compile_error(c, SCRIPT_ERROR_TOO_LARGE, "Too many elif branches.", NULL);
+            return;
+        }
+        end_jumps[end_count++] = emit(c, SCRIPT_OP_JUMP);
+        patch(c, skip);
+
+        if (token_is(c, "elif")) {
+            scan(c);
+            continue;
+        }
+        if (token_is(c, "else")) {
+            scan(c);
+            parse_list(c);
+        } else {
+            emit_true(c); // 没有分支被执行时状态为 0
+        }
+        break;
+    }
+    expect(c, "fi");
+    for (int i = 0; i < end_count; i++) {
+        patch(c, end_jumps[i]);
+    }
+}
+
+// while/until LIST do LIST done
+static void parse_while(ScriptCompiler *c, bool until) {
+    int top = c->instr_count;
+    scan(c);
+    parse_list(c);
+    expect(c, "do");
+    int exit = emit(c, until ? SCRIPT_OP_JUMP_IF_OK : SCRIPT_OP_JUMP_IF_FAIL);
+    parse_list(c);
+    expect(c, "done");
+    int back = emit(c, SCRIPT_OP_JUMP);
+    c->instrs[back].target = (uint16_t)top;
+    patch(c, exit);
+    emit_true(c);
+}
+
+// for NAME in WORDS...; do LIST done
+static void parse_for(ScriptCompiler *c) {
+    scan(c);
+    if (c->token != TOKEN_WORD) {
+        compile_error(c, SCRIPT_ERROR_SYNTAX, "Syntax error: expected variable after 'for'.", NULL);
+        return;
+    }
+    int name = c->token_word;
+    const ScriptWord *word = &c->words[name];
+    if (word->expand || !script_is_identifier(c->pool + word->offset, word->length)) {
+        compile_error(c, SCRIPT_ERROR_SYNTAX, "Syntax error: invalid loop variable.", NULL);
+        return;
+    }
+    if (c->loop_depth >= SCRIPT_MAX_SLOTS) {
+        compile_error(c, SCRIPT_ERROR_TOO_LARGE, "Loops nested too deeply.", NULL);
+        return;
+    }
+    scan(c);
+    if (!token_is(c, "in")) {
+        compile_error(c, SCRIPT_ERROR_SYNTAX, "Syntax error: expected ", "in");
+        return;
+    }
+    scan(c);
+
+    // 列表单词按扫描顺序连续存放
+    int first = c->word_count;
+    int count = 0;
+    while (c->token == TOKEN_WORD && c->failure == 0) {
+        first = count == 0 ? c->token_word : first;
+        count++;
+        scan(c);
+    }
+    while (c->token == TOKEN_SEPARATOR) {
+        scan(c);
+    }
+    expect(c, "do");
+
+    int slot = c->loop_depth++;
+    int init = emit(c, SCRIPT_OP_FOR_INIT);
+    c->instrs[init].command = (int16_t)slot;
+    int top = emit(c, SCRIPT_OP_FOR_NEXT);
+    c->instrs[top].command = (int16_t)slot;
+    c->instrs[top].word = (uint16_t)first;
+    c->instrs[top].argc = (uint8_t)count;
+    c->instrs[top].arg = (uint16_t)name;
+
+    parse_list(c);
+    expect(c, "done");
+    int back = emit(c, SCRIPT_OP_JUMP);
+    c->instrs[back].target = (uint16_t)top;
+    patch(c, top);
+    c->loop_depth--;
+}
+
+// 单条命令或控制结构
+static void parse_command(ScriptCompiler *c) {
+    if (token_is(c, "if")) {
+        parse_if(c);
+    } else if (token_is(c, "while")) {
+        parse_while(c, false);
+    } else if (token_is(c, "until")) {
+        parse_while(c, true);
+    } else if (token_is(c, "for")) {
+        parse_for(c);
+    } else if (c->token == TOKEN_WORD && !token_is_terminator(c)) {
+        parse_simple(c);
+    } else {
+        compile_error(c, SCRIPT_ERROR_SYNTAX, "Syntax error: unexpected token.", NULL);
+    }
+}
+
+// 命令 [&& 命令 | || 命令]...
+static void parse_and_or(ScriptCompiler *c) {
+    parse_command(c);
+    while ((c->token == TOKEN_AND || c->token == TOKEN_OR) && c->failure == 0) {
+        int jump = emit(c, c->token == TOKEN_AND ? SCRIPT_OP_JUMP_IF_FAIL : SCRIPT_OP_JUMP_IF_OK);
+        scan(c);
+        while (c->token == TOKEN_SEPARATOR && c->source[c->pos - 1] == '\n') {
+            scan(c); // 允许在 && / || 后换行
+        }
+        parse_command(c);
+        patch(c, jump);
+    }
+}
+
+// 语句列表，遇到结束关键字或源码结束时返回
+static void parse_list(ScriptCompiler *c) {
+    while (c->failure == 0) {
+        while (c->token == TOKEN_SEPARATOR) {
+            scan(c);
+        }
+        if (c->token == TOKEN_END || token_is_terminator(c)) {
+            return;
+        }
+        parse_and_or(c);
+        if (c->token != TOKEN_SEPARATOR) {
+            return;
+        }
+    }
+}
+
+// 编译脚本，结果一次性分配并按实际大小打包
+static CompiledScript *script_compile(ScriptManager *self, const char *source, size_t length, uint32_t hash, int *failure) {
+    ScriptCompiler *c = &compiler;
+    c->manager = self;
+    c->source = source;
+    c->length = length;
+    c->pos = 0;
+    c->instr_count = 0;
+    c->word_count = 0;
+    c->pool_size = 0;
+    c->loop_depth = 0;
+    c->failure = 0;
+
+    scan(c);
+    parse_list(c);
+    if (c->failure == 0 && c->token != TOKEN_END) {
+        compile_error(c, SCRIPT_ERROR_SYNTAX, "Syntax error: unexpected keyword.", NULL);
+    }
+    if (c->failure != 0) {
+        *failure = c->failure;
+        return NULL;
+    }
+
+    size_t instr_bytes = c->instr_count * sizeof(ScriptInstr);
+    size_t word_bytes = c->word_count * sizeof(ScriptWord);
+    CompiledScript *script = (CompiledScript *)malloc(sizeof(CompiledScript) + instr_bytes + word_bytes +
+                                                      c->pool_size + length + 1);
+    if (script == NULL) {
+        compile_error(c, SCRIPT_ERROR_TOO_LARGE, "Out of memory.", NULL);
+        *failure = SCRIPT_ERROR_TOO_LARGE;
+        return NULL;
+    }
+
+    unsigned char *cursor = (unsigned char *)(script + 1);
+    memcpy(cursor, c->instrs, instr_bytes);
+    script->instrs = (const ScriptInstr *)cursor;
+    cursor += instr_bytes;
+    memcpy(cursor, c->words, word_bytes);
+    script->words = (const ScriptWord *)cursor;
+    cursor += word_bytes;
+    memcpy(cursor, c->pool, c->pool_size);
+    script->pool = (const char *)cursor;
+    cursor += c->pool_size;
+    memcpy(cursor, source, length + 1);
+    script->source = (const char *)cursor;
+
+    script->hash = hash;
+    script->source_length = (uint32_t)length;
+    script->last_used = 0;
+    script->running = 0;
+    script->instr_count = (uint16_t)c->instr_count;
+    script->word_count = (uint16_t)c->word_count;
+    return script;
+}
+
+// ========== 执行 ==========
+
+// 展开单词到 out，返回写入长度；空间不足时返回 -1
+static int script_expand_word(ScriptManager *self, const CompiledScript *script, const ScriptWord *word,
+                              char *out, size_t size) {
+    const char *text = script->pool + word->offset;
+    size_t used = 0;
+
+    if (!word->expand) {
+        if (word->length >= size) {
+            return -1;
+        }
+        memcpy(out, text, word->length);
+        out[word->length] = '\0';
+        return word->length;
+    }
+
+    for (size_t i = 0; i < word->length; i++) {
+        const char *piece = NULL;
+        size_t piece_length = 1;
+        char status[12];
+
+        if (text[i] == '\\' && i + 1 < word->length) {
+            piece = &text[++i];
+        } else if (text[i] == '$' && i + 1 < word->length && text[i + 1] == '?') {
+            snprintf(status, sizeof(status), "%d", self->last_status);
+            piece = status;
+            piece_length = strlen(status);
+            i++;
+        } else if (text[i] == '$' && i + 1 < word->length) {
+            // $NAME 或 ${NAME}
+            bool braced = text[i + 1] == '{';
+            size_t start = i + 1 + braced;
+            size_t end = start;
+            while (end < word->length && (isalnum((unsigned char)text[end]) || text[end] == '_')) {
+                end++;
+            }
+            if (end == start || (braced && (end >= word->length || text[end] != '}'))) {
+                piece = &text[i]; // 不是变量引用，按字面输出 '$'
+            } else {
+                ScriptVariable *var = script_find_variable(self, text + start, end - start);
+                piece = var ? var->value : "";
+                piece_length = strlen(piece);
+                i = braced ? end : end - 1;
+            }
+        } else {
+            piece = &text[i];
+        }
+
+        if (used + piece_length >= size) {
+            return -1;
+        }
+        memcpy(out + used, piece, piece_length);
+        used += piece_length;
+    }
+    out[used] = '\0';
+    return (int)used;
+}
+
+// 执行一条 EXEC 指令：展开参数后直接按编号分发，不再重新分词
+static int script_exec(ScriptManager *self, const CompiledScript *script, const ScriptInstr *instr) {
+    char buffer[SCRIPT_ARG_BUFFER_SIZE];
+    char *argv[MAX_ARGC];
+    size_t used = 0;
+
+    for (int i = 0; i < instr->argc; i++) {
+        int length = script_expand_word(self, script, &script->words[instr->word + i], buffer + used, sizeof(buffer) - used);
+        if (length < 0) {
+            snprintf(self->error, sizeof(self->error), "Arguments too long.");
+            return SCRIPT_ERROR_TOO_LARGE;
+        }
+        argv[i] = buffer + used;
+        used += length + 1;
+    }
+
+    int command = instr->command;
+    if (command == SCRIPT_COMMAND_DYNAMIC) {
+        command = script_find_builtin(argv[0], strlen(argv[0]));
+        if (command == SCRIPT_COMMAND_DYNAMIC) {
+            CommandManager *cm = get_command_manager();
+            command = cm->find_command(cm, argv[0]);
+            if (command < 0) {
+                command_report_not_found(argv[0]); // 立即报告，序列中后续命令的状态不会掩盖它
+                return COMMAND_ERROR_NOT_FOUND;
+            }
+        }
+    }
+
+    if (command <= SCRIPT_BUILTIN_BASE) {
+        return builtins[SCRIPT_BUILTIN_BASE - command].function(self, instr->argc, argv);
+    }
+    CommandManager *cm = get_command_manager();
+    return cm->execute_by_id(cm, command, instr->argc, argv);
+}
+
+// 解释执行字节码
+static int script_execute(ScriptManager *self, const CompiledScript *script) {
+    uint16_t loop_index[SCRIPT_MAX_SLOTS] = { 0 };
+    unsigned long steps = 0;
+    int status = 0;
+    int pc = 0;
+
+    while (pc < script->instr_count) {
+        if (++steps > SCRIPT_MAX_STEPS) {
+            snprintf(self->error, sizeof(self->error), "Script exceeded %d steps.", SCRIPT_MAX_STEPS);
+            return SCRIPT_ERROR_STEP_LIMIT;
+        }
+
+        const ScriptInstr *instr = &script->instrs[pc++];
+        switch (instr->op) {
+            case SCRIPT_OP_EXEC:
+                status = script_exec(self, script, instr);
+                self->last_status = status;
+                break;
+            case SCRIPT_OP_JUMP:
+                pc = instr->target;
+                break;
+            case SCRIPT_OP_JUMP_IF_FAIL:
+                if (status != 0) {
+                    pc = instr->target;
+                }
+                break;
+            case SCRIPT_OP_JUMP_IF_OK:
+                if (status == 0) {
+                    pc = instr->target;
+                }
+                break;
+            case SCRIPT_OP_FOR_INIT:
+                loop_index[instr->command] = 0;
+                break;
+            case SCRIPT_OP_FOR_NEXT: {
+                uint16_t *index = &loop_index[instr->command];
+                if (*index >= instr->argc) {
+                    pc = instr->target;
+                    break;
+                }
+                char name[SCRIPT_NAME_SIZE];
+                char value[SCRIPT_VALUE_SIZE];
+                const ScriptWord *var = &script->words[instr->arg];
+                memcpy(name, script->pool + var->offset, var->length);
+                name[var->length] = '\0';
+                if (script_expand_word(self, script, &script->words[instr->word + *index], value, sizeof(value)) < 0) {
+                    value[0] = '\0';
+                }
+                script_set_variable(self, name, value);
+                (*index)++;
+                break;
+            }
+        }
+    }
+    return status;
+}
+
+// ========== 缓存 ==========
+
+// FNV-1a 哈希
+static uint32_t script_hash(const char *source, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)source[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 在缓存中查找编译结果
+static CompiledScript *script_cache_lookup(ScriptManager *self, const char *source, size_t length, uint32_t hash) {
+    for (int i = 0; i < SCRIPT_CACHE_SIZE; i++) {
+        CompiledScript *script = self->cache[i];
+        if (script != NULL && script->hash == hash && script->source_length == length &&
+            memcmp(script->source, source, length) == 0) {
+            return script;
+        }
+    }
+    return NULL;
+}
+
+// 放入缓存，淘汰最久未用且未在执行的条目；无法放入时返回 false
+static bool script_cache_insert(ScriptManager *self, CompiledScript *script) {
+    int victim = -1;
+    for (int i = 0; i < SCRIPT_CACHE_SIZE; i++) {
+        if (self->cache[i] == NULL) {
+            victim = i;
+            break;
+        }
+        if (self->cache[i]->running == 0 &&
+            (victim < 0 || self->cache[i]->last_used < self->cache[victim]->last_used)) {
+            victim = i;
+        }
+    }
+    if (victim < 0) {
+        return false;
+    }
+    free(self->cache[victim]);
+    self->cache[victim] = script;
+    return true;
+}
+
+// 编译（或命中缓存）并运行脚本
+static int script_run(ScriptManager *self, const char *source) {
+    size_t length = strlen(source);
+    self->error[0] = '\0';
+    if (length > SCRIPT_MAX_SOURCE) {
+        snprintf(self->error, sizeof(self->error), "Script too large.");
+        return SCRIPT_ERROR_TOO_LARGE;
+    }
+
+    uint32_t hash = script_hash(source, length);
+    CompiledScript *script = script_cache_lookup(self, source, length, hash);
+    bool cached = true;
+    if (script != NULL) {
+        self->cache_hits++;
+    } else {
+        int failure = 0;
+        self->cache_misses++;
+        script = script_compile(self, source, length, hash, &failure);
+        if (script == NULL) {
+            return failure;
+        }
+        cached = script_cache_insert(self, script);
+    }
+
+    script->last_used = ++self->clock;
+    script->running++;
+    int status = script_execute(self, script);
+    script->running--;
+    if (!cached) {
+        free(script);
+    }
+    return status;
+}
+
+// 获取单例脚本解释器的指针
+ScriptManager* get_script_manager() {
+    script_manager.run = script_run;
+    script_manager.get_variable = script_get_variable;
+    script_manager.set_variable = script_set_variable;
+    return &script_manager;
+}
+
+#endif // SHELL_FEATURE_SCRIPT
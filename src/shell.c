@@ -9,6 +9,11 @@
 #include "history.h"
 #include "pal.h"
 #include "log.h"
+#include "output.h"
+#include "watch.h"
+#include "proc.h"
+#include "file.h"
+#include "module.h"
 #if defined(ENABLE_FREERTOS) && (ENABLE_FREERTOS == 1)
 #include "FreeRTOS.h"
 #include "task.h"
@@ -20,21 +25,43 @@
 #define KEY_LEFT 68
 #define KEY_RIGHT 67
 #define KEY_ENTER 10
+#define KEY_RETURN 13
 #define KEY_BACKSPACE 127
 #define KEY_TAB '\t'
+#define KEY_CTRL_F 6
 
 // 命令函数声明
 static void hello_command(int argc, char *argv[]);
 static void list_command(int argc, char *argv[]);
 static void reboot_command(int argc, char *argv[]);
 static void clear_command(int argc, char *argv[]);
-static void log_command(int argc, char *argv[]);
+static void log_command(const void *args);
+#if !(defined(__linux__) && SHELL_FEATURE_PROC)
 static void ps_command(int argc, char *argv[]);
+#endif
+#if SHELL_FEATURE_SCRIPT
+static void source_command(int argc, char *argv[]);
+#endif
+
+// log 命令的参数：log -level <0..2> | log -stats
+typedef struct LogArgs {
+    int level;      // -level，未给出时为 -1
+    bool stats;     // -stats
+} LogArgs;
+
+static const CommandArg log_args[] = {
+    COMMAND_ARG_INT("-level", LogArgs, level, 0, 2, -1),
+    COMMAND_ARG_FLAG("-stats", LogArgs, stats),
+};
+static const CommandSchema log_schema = COMMAND_SCHEMA(log_args, LogArgs, COMMAND_SCHEMA_ONE_OF);
 
 // 打印带颜色的 Shell Logo 和版本信息
 static void print_logo(Shell *self) {
+#if SHELL_FEATURE_LOGO
     // 蓝色输出 Logo
+#if SHELL_FEATURE_LOG_COLOR
     self->pal->uart_send("\033[34m");  // 设置蓝色
+#endif
     self->pal->uart_send("\n");
     self->pal->uart_send(" ____  _          _ _ \n");
     self->pal->uart_send("/ ___|| |__   ___| | |\n");
@@ -42,17 +69,28 @@ static void print_logo(Shell *self) {
     self->pal->uart_send(" ___) | | | |  __/ | |\n");
     self->pal->uart_send("|____/|_| |_|\\___|_|_|\n");
     self->pal->uart_send("\n");
+#endif
 
     // 绿色输出版本信息
     char version_info[64];
     snprintf(version_info, sizeof(version_info), "Embedded Shell v%s\n", SHELL_VERSION);
+#if SHELL_FEATURE_LOG_COLOR
     self->pal->uart_send("\033[32m");  // 设置绿色
     self->pal->uart_send(version_info);
 
     // 重置颜色
     self->pal->uart_send("\033[0m");
+#else
+    self->pal->uart_send(version_info);
+#endif
+}
+
+// 发送交互回显，优先级高于命令输出和日志
+static void shell_echo(Shell *self, const char *str) {
+    self->output_manager->send(self->output_manager, OUTPUT_PRIORITY_ECHO, str);
 }
 
+#if SHELL_FEATURE_LOGIN
 // 验证密码函数
 static bool verify_password(Shell *self, const char *password) {
     return strcmp(password, DEFAULT_PASSWORD) == 0;
@@ -65,24 +103,30 @@ static bool login(Shell *self) {
 
     while (attempts > 0) {
         // 每次新输入时显示提示符
-        self->pal->uart_send("Enter password: ");
+        shell_echo(self, "Enter password: ");
 
         int idx = 0;
         while (true) {
-            int ch = self->pal->get_char();
-            if (ch == KEY_ENTER) {
+            // 等待输入期间分块写出日志，有按键时优先处理回显
+            self->output_manager->service(self->output_manager);
+            int ch = self->output_manager->read_char(self->output_manager);
+            if (ch < 0) {
+                self->log_manager->log(LOG_LEVEL_ERROR, "Input closed during login.");
+                return false; // 输入已关闭
+            }
+            if (ch == KEY_ENTER || ch == KEY_RETURN) {
                 password_input[idx] = '\0';
                 break;
             } else if (ch == KEY_BACKSPACE && idx > 0) {
                 idx--;
-                self->pal->uart_send("\b \b");
+                shell_echo(self, "\b \b");
             } else if (idx < sizeof(password_input) - 1) {
                 password_input[idx++] = ch;
-                self->pal->uart_send("*"); // 显示掩码
+                shell_echo(self, "*"); // 显示掩码
             }
         }
 
-        self->pal->uart_send("\n");
+        shell_echo(self, "\n");
 
         if (self->verify_password(self, password_input)) {
             self->log_manager->log(LOG_LEVEL_INFO, "Access granted.");
@@ -95,7 +139,7 @@ static bool login(Shell *self) {
 
             // 提示重新输入
             if (attempts > 0) {
-                self->pal->uart_send("Please try again.\n");
+                shell_echo(self, "Please try again.\n");
             }
         }
     }
@@ -103,33 +147,66 @@ static bool login(Shell *self) {
     self->log_manager->log(LOG_LEVEL_ERROR, "Access denied. Login failed after 3 attempts.");
     return false;
 }
+#endif // SHELL_FEATURE_LOGIN
 
 
 // 初始化 Shell
 static void shell_init(Shell *self) {
     self->pal->init();
 
+#if SHELL_FEATURE_LOGIN
     // 执行登录过程
     if (!login(self)) {
         // 登录失败，退出程序
+        self->output_manager->flush(self->output_manager);
         exit(0);
     }
+#endif
 
     print_logo(self);
 
     // 初始化历史记录和命令
+#if SHELL_FEATURE_HISTORY
     self->history_manager->init(self->history_manager);
+#endif
     self->command_manager->register_command(self->command_manager, "hello", hello_command);
     self->command_manager->register_command(self->command_manager, "list", list_command);
     self->command_manager->register_command(self->command_manager, "reboot", reboot_command);
     self->command_manager->register_command(self->command_manager, "clear", clear_command);
-    self->command_manager->register_command(self->command_manager, "log", log_command);
+    self->command_manager->register_schema_command(self->command_manager, "log", &log_schema, log_command);
+#if defined(__linux__) && SHELL_FEATURE_PROC
+    self->command_manager->register_schema_command(self->command_manager, "ps", &proc_ps_schema, proc_ps_command);
+#else
     self->command_manager->register_command(self->command_manager, "ps", ps_command);
+#endif
+#if SHELL_FEATURE_SCRIPT
+    self->command_manager->register_command(self->command_manager, "source", source_command);
+#endif
+#if SHELL_FEATURE_WATCH
+    self->command_manager->register_schema_command(self->command_manager, "watch", &watch_schema, watch_command);
+#endif
+#if defined(__linux__) && SHELL_FEATURE_FILE
+    self->command_manager->register_schema_command(self->command_manager, "cat", &file_cat_schema, file_cat_command);
+    self->command_manager->register_schema_command(self->command_manager, "hexdump", &file_hexdump_schema, file_hexdump_command);
+    self->command_manager->register_schema_command(self->command_manager, "tail", &file_tail_schema, file_tail_command);
+#endif
 
     // 注册别名
     self->command_manager->register_alias(self->command_manager, "ls", "list");
     self->command_manager->register_alias(self->command_manager, "rb", "reboot");
 
+#if defined(__linux__) && SHELL_FEATURE_MODULES
+    // 按清单注册模块命令，模块在首次调用时才加载
+    self->command_manager->register_command(self->command_manager, "module", module_command);
+    ModuleManager *module_manager = get_module_manager();
+    int module_commands = module_manager->load_manifest(module_manager, SHELL_MODULE_MANIFEST);
+    if (module_commands > 0) {
+        char message[64];
+        snprintf(message, sizeof(message), "Registered %d module command(s).", module_commands);
+        self->log_manager->log(LOG_LEVEL_INFO, message);
+    }
+#endif
+
     // 设置日志级别并记录初始化完成日志
     self->log_manager->set_level(LOG_LEVEL_INFO);
     self->log_manager->log(LOG_LEVEL_INFO, "Shell initialized successfully.");
@@ -146,8 +223,23 @@ static int shell_register_command(Shell *self, const char *name, CommandFunction
     return result;
 }
 
-// 自动补全命令
+#if SHELL_FEATURE_COMPLETION
+// 自动补全命令名；命令名之后按参数模式补全选项名和枚举值
 static void autocomplete_command(Shell *self) {
+    if (strchr(self->input_buffer, ' ') != NULL) {
+        int word_start = 0;
+        const char *completion = self->command_manager->complete_argument(self->command_manager, self->input_buffer, &word_start);
+        if (completion != NULL) {
+            snprintf(self->input_buffer + word_start, sizeof(self->input_buffer) - word_start, "%s ", completion);
+            self->buffer_length = strlen(self->input_buffer);
+            self->cursor_position = self->buffer_length;
+            shell_echo(self, "\r");
+            shell_echo(self, "shell> ");
+            shell_echo(self, self->input_buffer);
+        }
+        return;
+    }
+
     int match_count = 0;
     const char *last_match = NULL;
     size_t input_length = strlen(self->input_buffer);
@@ -166,17 +258,21 @@ static void autocomplete_command(Shell *self) {
     if (match_count == 1 && last_match) {
         strncpy(self->input_buffer, last_match, INPUT_BUFFER_SIZE - 1);
         self->buffer_length = strlen(self->input_buffer);
-        self->pal->uart_send("\r");
-        self->pal->uart_send("shell> ");
-        self->pal->uart_send(self->input_buffer);
+        self->cursor_position = self->buffer_length;
+        shell_echo(self, "\r");
+        shell_echo(self, "shell> ");
+        shell_echo(self, self->input_buffer);
     }
 }
+#endif // SHELL_FEATURE_COMPLETION
 
 // 处理输入命令
 static void process_input(Shell *self) {
     if (self->buffer_length > 0) {
         self->input_buffer[self->buffer_length] = '\0';
+#if SHELL_FEATURE_HISTORY
         self->history_manager->add(self->history_manager, self->input_buffer);
+#endif
 
         char log_message[256];
         snprintf(log_message, sizeof(log_message), "Processing command: %s", self->input_buffer);
@@ -184,11 +280,18 @@ static void process_input(Shell *self) {
 
         if (strcmp(self->input_buffer, "exit") == 0) {
             self->log_manager->log(LOG_LEVEL_WARN, "Shell is exiting.");
+            self->output_manager->flush(self->output_manager);
             exit(0);
         }
 
+#if SHELL_FEATURE_SCRIPT
+        // 经脚本解释器执行，支持 ; && || 、变量和控制结构；正数状态表示条件为假，不是错误
+        int result = self->script_manager->run(self->script_manager, self->input_buffer);
+#else
+        // 未编译脚本解释器时整行作为一条命令执行
         int result = self->command_manager->execute_command(self->command_manager, self->input_buffer);
-        if (result != COMMAND_SUCCESS) {
+#endif
+        if (result < COMMAND_SUCCESS) {
             // 记录具体的错误信息
             switch (result) {
                 case COMMAND_ERROR_TABLE_FULL:
@@ -201,13 +304,27 @@ static void process_input(Shell *self) {
                     self->log_manager->log(LOG_LEVEL_ERROR, "No input provided for command.");
                     break;
                 case COMMAND_ERROR_NOT_FOUND:
-                    self->log_manager->log(LOG_LEVEL_ERROR, "Command not found.");
+                    break; // 查找失败时已记录，并附带拼写建议
+                case COMMAND_ERROR_INVALID_ARGS:
+                    break; // 分发时已记录参数错误和用法
+#if SHELL_FEATURE_SCRIPT
+                case SCRIPT_ERROR_SYNTAX:
+                case SCRIPT_ERROR_TOO_LARGE:
+                case SCRIPT_ERROR_STEP_LIMIT:
+                    self->log_manager->log(LOG_LEVEL_ERROR, self->script_manager->error);
                     break;
+#endif
                 default:
                     self->log_manager->log(LOG_LEVEL_ERROR, "Unknown command error.");
                     break;
             }
         }
+
+#if defined(__linux__) && SHELL_FEATURE_MODULES
+        // 卸载长时间未使用的模块
+        ModuleManager *module_manager = get_module_manager();
+        module_manager->unload_idle(module_manager, MODULE_IDLE_TIMEOUT);
+#endif
         
         // 重置缓冲区和游标位置
         self->buffer_length = 0;
@@ -217,11 +334,150 @@ static void process_input(Shell *self) {
 }
 
 
+// 在游标位置插入一段文本，后续字符后移，整行只重绘一次；缓冲区放不下时不插入
+static bool shell_insert_text(Shell *self, const char *text, int length) {
+    if (self->buffer_length + length > (int)sizeof(self->input_buffer) - 1) {
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+    memmove(&self->input_buffer[self->cursor_position + length],
+            &self->input_buffer[self->cursor_position],
+            self->buffer_length - self->cursor_position);
+    memcpy(&self->input_buffer[self->cursor_position], text, length);
+    self->buffer_length += length;
+    self->cursor_position += length;
+    self->input_buffer[self->buffer_length] = '\0';
+
+    // 重新显示缓冲区内容
+    shell_echo(self, "\r");  // 回到行首
+    shell_echo(self, "shell> ");
+    shell_echo(self, self->input_buffer);
+
+    // 移动光标到新的位置
+    int move_left = self->buffer_length - self->cursor_position;
+    if (move_left > 0) {
+        char move[16];
+        snprintf(move, sizeof(move), "\033[%dD", move_left);
+        shell_echo(self, move);
+    }
+    return true;
+}
+
+#if SHELL_FEATURE_HISTORY && SHELL_FEATURE_HINT
+// 光标在行尾时以暗色显示得分最高的历史命令的剩余部分，光标保持不动
+static void shell_show_hint(Shell *self) {
+    if (self->buffer_length == 0 || self->cursor_position != self->buffer_length) {
+        return;
+    }
+    const char *hint = self->history_manager->suggest(self->history_manager, self->input_buffer);
+    if (hint == NULL) {
+        return;
+    }
+    char move[16];
+    snprintf(move, sizeof(move), "\033[%dD", (int)strlen(hint));
+    shell_echo(self, "\033[2m");
+    shell_echo(self, hint);
+    shell_echo(self, "\033[0m");
+    shell_echo(self, move);
+    self->hint = hint;
+}
+
+// 擦除正在显示的提示，返回被擦除的提示
+static const char* shell_clear_hint(Shell *self) {
+    const char *hint = self->hint;
+    if (hint != NULL) {
+        shell_echo(self, "\033[K");
+        self->hint = NULL;
+    }
+    return hint;
+}
+#endif // SHELL_FEATURE_HISTORY && SHELL_FEATURE_HINT
+
+#if SHELL_FEATURE_PASTE
+// 暂存一个粘贴字符：回车和回车换行统一为 '\n'，制表符转为空格，其他控制字符丢弃
+// 返回 false 表示缓冲区已满
+static bool shell_paste_put(Shell *self, int ch, int *previous) {
+    int last = *previous;
+    *previous = ch;
+    if (ch == '\n' && last == '\r') {
+        return true;
+    }
+    if (ch == '\r') {
+        ch = '\n';
+    } else if (ch == '\t') {
+        ch = ' ';
+    } else if ((ch < ' ' && ch != '\n') || ch == KEY_BACKSPACE) {
+        return true;
+    }
+    if (self->paste_length >= (int)sizeof(self->paste_buffer)) {
+        return false;
+    }
+    self->paste_buffer[self->paste_length++] = (char)ch;
+    return true;
+}
+
+// 读取粘贴内容直到结束序列 ESC[201~
+static void shell_read_paste(Shell *self) {
+    static const char end[] = SHELL_PASTE_END;
+    int matched = 0;
+    int previous = 0;
+    unsigned long dropped = 0;
+
+    while (matched < (int)sizeof(end) - 1) {
+        int ch = self->output_manager->read_char(self->output_manager);
+        if (ch < 0) {
+            break;
+        }
+        if (ch == end[matched]) {
+            matched++;
+            continue;
+        }
+        // 不是结束序列：补回已匹配的前缀（ESC 只出现在结束序列开头）
+        for (int i = 0; i < matched; i++) {
+            dropped += !shell_paste_put(self, end[i], &previous);
+        }
+        matched = ch == end[0];
+        if (!matched) {
+            dropped += !shell_paste_put(self, ch, &previous);
+        }
+    }
+    if (dropped > 0) {
+        char message[64];
+        snprintf(message, sizeof(message), "Paste truncated: %lu byte(s) dropped.", dropped);
+        self->log_manager->log(LOG_LEVEL_WARN, message);
+    }
+}
+
+// 将粘贴内容的下一行整体插入编辑区；返回 true 表示该行以换行结束，应立即执行
+// 放不下的行不会被截断执行，连同其后的行一起丢弃
+static bool shell_paste_take_line(Shell *self) {
+    char *newline = memchr(self->paste_buffer, '\n', self->paste_length);
+    int length = newline ? (int)(newline - self->paste_buffer) : self->paste_length;
+    int consumed = newline ? length + 1 : length;
+
+    if (!shell_insert_text(self, self->paste_buffer, length)) {
+        self->log_manager->log(LOG_LEVEL_WARN, "Pasted line too long, paste discarded.");
+        self->paste_length = 0;
+        return false;
+    }
+    self->paste_length -= consumed;
+    memmove(self->paste_buffer, self->paste_buffer + consumed, self->paste_length);
+    return newline != NULL;
+}
+#endif // SHELL_FEATURE_PASTE
+
 // 事件处理器
 static void shell_handle_event(Shell *self, ShellEvent event, int data) {
+#if SHELL_FEATURE_HISTORY && SHELL_FEATURE_HINT
+    // 每个按键先擦除提示，输入和删除字符后重新查找
+    const char *hint = shell_clear_hint(self);
+#endif
+
     switch (event) {
         case EVENT_KEY_ENTER:
-            self->pal->uart_send("\n");
+            shell_echo(self, "\n");
             process_input(self);
             self->buffer_length = 0;
             memset(self->input_buffer, 0, sizeof(self->input_buffer));
@@ -230,24 +486,35 @@ static void shell_handle_event(Shell *self, ShellEvent event, int data) {
         case EVENT_KEY_BACKSPACE:
             if (self->buffer_length > 0) {
                 self->buffer_length--;
-                self->pal->uart_send("\b \b");
+                self->input_buffer[self->buffer_length] = '\0';
+                if (self->cursor_position > self->buffer_length) {
+                    self->cursor_position = self->buffer_length;
+                }
+                shell_echo(self, "\b \b");
             }
+#if SHELL_FEATURE_HISTORY && SHELL_FEATURE_HINT
+            shell_show_hint(self);
+#endif
             break;
 
+#if SHELL_FEATURE_COMPLETION
         case EVENT_KEY_TAB:
             autocomplete_command(self);
             break;
+#endif
 
+#if SHELL_FEATURE_HISTORY
         case EVENT_KEY_UP: {
             const char *previous_command = self->history_manager->get_previous(self->history_manager);
             if (previous_command) {
                 while (self->buffer_length > 0) {
-                    self->pal->uart_send("\b \b");
+                    shell_echo(self, "\b \b");
                     self->buffer_length--;
                 }
                 strncpy(self->input_buffer, previous_command, sizeof(self->input_buffer) - 1);
                 self->buffer_length = strlen(self->input_buffer);
-                self->pal->uart_send(self->input_buffer);
+                self->cursor_position = self->buffer_length;
+                shell_echo(self, self->input_buffer);
             }
             break;
         }
@@ -256,53 +523,46 @@ static void shell_handle_event(Shell *self, ShellEvent event, int data) {
             const char *next_command = self->history_manager->get_next(self->history_manager);
             if (next_command) {
                 while (self->buffer_length > 0) {
-                    self->pal->uart_send("\b \b");
+                    shell_echo(self, "\b \b");
                     self->buffer_length--;
                 }
                 strncpy(self->input_buffer, next_command, sizeof(self->input_buffer) - 1);
                 self->buffer_length = strlen(self->input_buffer);
-                self->pal->uart_send(self->input_buffer);
+                self->cursor_position = self->buffer_length;
+                shell_echo(self, self->input_buffer);
             }
             break;
         }
+#endif
 
         case EVENT_KEY_LEFT:
             if (self->cursor_position > 0) {
                 self->cursor_position--;
-                self->pal->uart_send("\b"); // 移动光标向左
+                shell_echo(self, "\b"); // 移动光标向左
             }
             break;
 
         case EVENT_KEY_RIGHT:
             if (self->cursor_position < self->buffer_length) {
-                self->pal->uart_send((char[]){self->input_buffer[self->cursor_position], '\0'});
+                shell_echo(self, (char[]){self->input_buffer[self->cursor_position], '\0'});
                 self->cursor_position++;
             }
+#if SHELL_FEATURE_HISTORY && SHELL_FEATURE_HINT
+            else if (hint != NULL) {
+                // 行尾按右方向键（或 Ctrl-F）接受提示
+                shell_insert_text(self, hint, strlen(hint));
+            }
+#endif
             break;
 
-        case EVENT_KEY_CHAR:
-            if (self->buffer_length < sizeof(self->input_buffer) - 1) {
-                // 将字符插入到游标位置，并将缓冲区后续字符后移
-                memmove(&self->input_buffer[self->cursor_position + 1],
-                        &self->input_buffer[self->cursor_position],
-                        self->buffer_length - self->cursor_position);
-
-                self->input_buffer[self->cursor_position] = (char)data; // 插入字符
-                self->buffer_length++;
-                self->cursor_position++;
-
-                // 重新显示缓冲区内容
-                self->pal->uart_send("\r");  // 回到行首
-                self->pal->uart_send("shell> ");
-                self->pal->uart_send(self->input_buffer);
-
-                // 移动光标到新的位置
-                int move_left = self->buffer_length - self->cursor_position;
-                for (int i = 0; i < move_left; i++) {
-                    self->pal->uart_send("\b");
-                }
-            }
+        case EVENT_KEY_CHAR: {
+            char ch = (char)data;
+            shell_insert_text(self, &ch, 1);
+#if SHELL_FEATURE_HISTORY && SHELL_FEATURE_HINT
+            shell_show_hint(self);
+#endif
             break;
+        }
 
         default:
             break;
@@ -312,24 +572,59 @@ static void shell_handle_event(Shell *self, ShellEvent event, int data) {
 // Shell 主循环
 static void shell_loop(Shell *self) {
     while (true) {
-        self->pal->uart_send("shell> ");
+        // 输出提示符前写出积压的日志
+        self->output_manager->flush(self->output_manager);
+        shell_echo(self, "shell> ");
         self->buffer_length = 0;
         memset(self->input_buffer, 0, sizeof(self->input_buffer));
 
+#if SHELL_FEATURE_PASTE
+        // 多行粘贴的后续行逐条执行，最后一行没有换行时留在编辑区
+        if (self->paste_length > 0 && shell_paste_take_line(self)) {
+            self->handle_event(self, EVENT_KEY_ENTER, 0);
+            continue;
+        }
+#endif
+
         while (true) {
-            int ch = self->pal->get_char();
+            // 等待输入期间分块写出日志，有按键时优先处理回显
+            self->output_manager->service(self->output_manager);
+            int ch = self->output_manager->read_char(self->output_manager);
+
+            // 输入已关闭（如标准输入到达 EOF）：与 exit 一样结束，不再把 -1 当作字符插入
+            if (ch < 0) {
+                shell_echo(self, "\n");
+                self->log_manager->log(LOG_LEVEL_WARN, "Input closed, shell is exiting.");
+                self->output_manager->flush(self->output_manager);
+                return;
+            }
+
+#if SHELL_FEATURE_RPC
+            // 行首出现同步字节时按二进制 RPC 帧处理
+            if (ch == RPC_SYNC0 && self->buffer_length == 0) {
+                self->rpc_manager->handle_frame(self->rpc_manager, ch);
+                continue;
+            }
+#endif
 
             // 根据输入字符产生事件
-            if (ch == KEY_ENTER) {
+            if (ch == KEY_ENTER || ch == KEY_RETURN) {
                 self->handle_event(self, EVENT_KEY_ENTER, 0);
                 break;
             } else if (ch == KEY_BACKSPACE) {
                 self->handle_event(self, EVENT_KEY_BACKSPACE, 0);
             } else if (ch == KEY_TAB) {
                 self->handle_event(self, EVENT_KEY_TAB, 0);
-            } else if (ch == 27) { // 方向键序列以 27 开头
-                self->pal->get_char(); // 跳过 '['
-                ch = self->pal->get_char();
+            } else if (ch == KEY_CTRL_F) {
+                self->handle_event(self, EVENT_KEY_RIGHT, 0);
+            } else if (ch == 27) { // 转义序列：ESC [ 参数 结束字符
+                self->output_manager->read_char(self->output_manager); // 跳过 '['
+                ch = self->output_manager->read_char(self->output_manager);
+                int param = 0;
+                while ((ch >= '0' && ch <= '9') || ch == ';') {
+                    param = ch == ';' ? 0 : param * 10 + (ch - '0');
+                    ch = self->output_manager->read_char(self->output_manager);
+                }
                 if (ch == KEY_UP) {
                     self->handle_event(self, EVENT_KEY_UP, 0);
                 } else if (ch == KEY_DOWN) {
@@ -338,6 +633,18 @@ static void shell_loop(Shell *self) {
                     self->handle_event(self, EVENT_KEY_LEFT, 0);
                 } else if (ch == KEY_RIGHT) {
                     self->handle_event(self, EVENT_KEY_RIGHT, 0);
+#if SHELL_FEATURE_PASTE
+                } else if (ch == '~' && param == SHELL_PASTE_BEGIN) {
+                    // 括号粘贴：整块读入后一次插入，含换行时立即执行第一行
+#if SHELL_FEATURE_HISTORY && SHELL_FEATURE_HINT
+                    shell_clear_hint(self);
+#endif
+                    shell_read_paste(self);
+                    if (shell_paste_take_line(self)) {
+                        self->handle_event(self, EVENT_KEY_ENTER, 0);
+                        break;
+                    }
+#endif
                 }
             } else {
                 self->handle_event(self, EVENT_KEY_CHAR, ch);
@@ -350,16 +657,33 @@ static void shell_loop(Shell *self) {
 Shell* create_shell() {
     Shell *shell = (Shell*)malloc(sizeof(Shell));
     shell->command_manager = get_command_manager();
+#if SHELL_FEATURE_HISTORY
     shell->history_manager = get_history_manager();
+#endif
     shell->pal = get_pal_interface();
     shell->log_manager = get_log_manager();  // 获取日志管理器
+    shell->output_manager = get_output_manager(); // 获取输出调度器
+#if SHELL_FEATURE_RPC
+    shell->rpc_manager = get_rpc_manager();       // 获取二进制 RPC 管理器
+#endif
+#if SHELL_FEATURE_SCRIPT
+    shell->script_manager = get_script_manager(); // 获取脚本解释器
+#endif
     shell->init = shell_init;
+#if SHELL_FEATURE_LOGIN
     shell->verify_password = verify_password;  // 设置验证函数
+#endif
     shell->loop = shell_loop;
     shell->register_command = shell_register_command;
     shell->handle_event = shell_handle_event;
     shell->buffer_length = 0;
     shell->cursor_position = 0;               // 初始化游标位置
+#if SHELL_FEATURE_PASTE
+    shell->paste_length = 0;
+#endif
+#if SHELL_FEATURE_HISTORY && SHELL_FEATURE_HINT
+    shell->hint = NULL;
+#endif
 
     // 初始化 Shell，包括命令和历史管理器
     shell->init(shell);
@@ -383,8 +707,28 @@ static void hello_command(int argc, char *argv[]) {
 }
 
 // List 命令实现
+// - list -m 输出注册表内存使用情况
 static void list_command(int argc, char *argv[]) {
     CommandManager *cm = get_command_manager();
+    if (argc > 1 && strcmp(argv[1], "-m") == 0) {
+        CommandMemoryStats stats;
+        char line[96];
+        cm->get_memory_stats(cm, &stats);
+        PalInterface *pal = get_pal_interface();
+        snprintf(line, sizeof(line), "Budget:   %zu bytes\n", stats.budget);
+        pal->uart_send(line);
+        snprintf(line, sizeof(line), "Reserved: %zu bytes\n", stats.reserved);
+        pal->uart_send(line);
+        snprintf(line, sizeof(line), "Used:     %zu bytes\n", stats.used);
+        pal->uart_send(line);
+        snprintf(line, sizeof(line), "Strings:  %d (%zu bytes)\n", stats.string_count, stats.string_bytes);
+        pal->uart_send(line);
+        snprintf(line, sizeof(line), "Commands: %d/%d\n", cm->get_command_count(cm), stats.command_capacity);
+        pal->uart_send(line);
+        snprintf(line, sizeof(line), "Aliases:  %d/%d\n", cm->get_alias_count(cm), stats.alias_capacity);
+        pal->uart_send(line);
+        return;
+    }
     for (int i = 0; i < cm->get_command_count(cm); i++) {
         const char *cmd_name = cm->get_command_name(cm, i);
         get_pal_interface()->uart_send(cmd_name);
@@ -404,46 +748,49 @@ static void clear_command(int argc, char *argv[]) {
     get_pal_interface()->uart_send("\033[H\033[J"); // 清屏 ANSI 转义码
 }
 
-// log 命令实现
-static void log_command(int argc, char *argv[]) {
+// log 命令实现：参数已按 log_schema 解析和校验
+static void log_command(const void *args) {
+    const LogArgs *options = (const LogArgs *)args;
     LogManager *log_manager = get_log_manager();
 
-    if (argc == 3 && strcmp(argv[1], "-level") == 0) {
-        int level = atoi(argv[2]);
-
-        switch (level) {
-            case 0:
-                log_manager->set_level(LOG_LEVEL_ERROR);
-                log_manager->log(LOG_LEVEL_INFO, "Log level set to ERROR.");
-                break;
-            case 1:
-                log_manager->set_level(LOG_LEVEL_WARN);
-                log_manager->log(LOG_LEVEL_INFO, "Log level set to WARN.");
-                break;
-            case 2:
-                log_manager->set_level(LOG_LEVEL_INFO);
-                log_manager->log(LOG_LEVEL_INFO, "Log level set to INFO.");
-                break;
-            default:
-                log_manager->log(LOG_LEVEL_ERROR, "Invalid log level. Use 0 for ERROR, 1 for WARN, or 2 for INFO.");
-                break;
-        }
-    } else {
-        log_manager->log(LOG_LEVEL_ERROR, "Usage: log -level <0|1|2>");
+    if (options->stats) {
+        // 输出调度器的日志丢弃与合并统计
+        OutputManager *output = get_output_manager();
+        OutputStats stats;
+        char line[128];
+        output->get_stats(output, &stats);
+        snprintf(line, sizeof(line), "Dropped: %lu message(s), %lu byte(s)\nCoalesced: %lu\nXOFF: %lu\n",
+                 stats.dropped_messages, stats.dropped_bytes, stats.coalesced_messages, stats.xoff_count);
+        get_pal_interface()->uart_send(line);
+        return;
     }
+
+    // -level 的取值范围 0..2 由参数模式保证
+    static const LogLevel levels[] = { LOG_LEVEL_ERROR, LOG_LEVEL_WARN, LOG_LEVEL_INFO };
+    static const char *const messages[] = {
+        "Log level set to ERROR.", "Log level set to WARN.", "Log level set to INFO."
+    };
+    log_manager->set_level(levels[options->level]);
+    log_manager->log(LOG_LEVEL_INFO, messages[options->level]);
 }
 
+#if !(defined(__linux__) && SHELL_FEATURE_PROC)
 static void ps_command(int argc, char *argv[]) {
-    LogManager *log_manager = get_log_manager();
-
     #if defined(ENABLE_FREERTOS) && (ENABLE_FREERTOS == 1) && \
         defined(configUSE_TRACE_FACILITY) && (configUSE_TRACE_FACILITY == 1) && \
         defined(configUSE_STATS_FORMATTING_FUNCTIONS) && (configUSE_STATS_FORMATTING_FUNCTIONS == 1)
 
+        LogManager *log_manager = get_log_manager();
+
         char buffer[1024];          // 用于存储任务信息的缓冲区
         const int refresh_delay = 500000;  // 刷新间隔（500毫秒）
         PalInterface *pal = get_pal_interface();
+        OutputManager *output = get_output_manager();
 
+        if (!output->claim_input(output)) {
+            log_manager->log(LOG_LEVEL_ERROR, "ps: needs console input to quit.");
+            return;
+        }
         log_manager->log(LOG_LEVEL_INFO, "Press 'q' to stop the task list refresh and return to shell.");
 
         while (true) {
@@ -469,9 +816,51 @@ static void ps_command(int argc, char *argv[]) {
         }
 
     #else
+        LogManager *log_manager = get_log_manager();
         log_manager->log(LOG_LEVEL_ERROR, "Error: FreeRTOS task list feature is disabled.");
         log_manager->log(LOG_LEVEL_ERROR, "Ensure ENABLE_FREERTOS, configUSE_TRACE_FACILITY, and configUSE_STATS_FORMATTING_FUNCTIONS are defined and set to 1.");
     #endif
 }
+#endif // Linux 上由 proc_ps_command 从 /proc 读取任务信息
+
+#if SHELL_FEATURE_SCRIPT
+// source 命令实现：读取脚本文件并交给脚本解释器执行
+static void source_command(int argc, char *argv[]) {
+    // 每层嵌套使用各自的静态缓冲区，不占用栈；超过 SCRIPT_MAX_DEPTH 层时拒绝（如脚本 source 自身）
+    static char sources[SCRIPT_MAX_DEPTH][SCRIPT_MAX_SOURCE + 1];
+    static int depth = 0;
+    LogManager *log_manager = get_log_manager();
+    if (argc != 2) {
+        log_manager->log(LOG_LEVEL_ERROR, "Usage: source <file>");
+        return;
+    }
+    if (depth >= SCRIPT_MAX_DEPTH) {
+        char message[64];
+        snprintf(message, sizeof(message), "source: nested more than %d levels.", SCRIPT_MAX_DEPTH);
+        log_manager->log(LOG_LEVEL_ERROR, message);
+        return;
+    }
 
-
+    FILE *file = fopen(argv[1], "r");
+    if (file == NULL) {
+        log_manager->log(LOG_LEVEL_ERROR, "Cannot open script file.");
+        return;
+    }
+    char *script = sources[depth];
+    size_t length = fread(script, 1, SCRIPT_MAX_SOURCE + 1, file);
+    fclose(file);
+    if (length > SCRIPT_MAX_SOURCE) {
+        log_manager->log(LOG_LEVEL_ERROR, "Script file too large.");
+        return;
+    }
+    script[length] = '\0';
+
+    ScriptManager *script_manager = get_script_manager();
+    depth++;
+    int result = script_manager->run(script_manager, script);
+    depth--;
+    if (result == SCRIPT_ERROR_SYNTAX || result == SCRIPT_ERROR_TOO_LARGE || result == SCRIPT_ERROR_STEP_LIMIT) {
+        log_manager->log(LOG_LEVEL_ERROR, script_manager->error);
+    }
+}
+#endif // SHELL_FEATURE_SCRIPT
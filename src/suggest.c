@@ -0,0 +1,144 @@
+#include "shell_config.h"
+
+#if SHELL_FEATURE_SUGGEST
+
+#include <stdio.h>
+#include <string.h>
+#include "suggest.h"
+#include "command.h"
+
+// 静态全局的拼写建议管理器单例
+static SuggestManager suggest_manager;
+
+// 可接受的最大编辑距离，随名称长度放宽
+static int suggest_threshold(size_t length) {
+    if (length <= 3) {
+        return 1;
+    }
+    return length <= 6 ? 2 : 3;
+}
+
+// Myers/Hyyrö 位并行算法计算模式与 text 的全局编辑距离，
+// 每个文本字符只需常数次位运算，模式长度不超过 64
+static int suggest_distance(const SuggestManager *self, int m, const char *text) {
+    uint64_t mask = m == 64 ? ~0ULL : ((1ULL << m) - 1);
+    uint64_t high = 1ULL << (m - 1);
+    uint64_t pv = mask;
+    uint64_t mv = 0;
+    int score = m;
+
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+        uint64_t eq = self->peq[*p];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | (~(xh | pv) & mask);
+        uint64_t mh = pv & xh;
+        if (ph & high) {
+            score++;
+        } else if (mh & high) {
+            score--;
+        }
+        ph = (ph << 1) | 1; // 全局比对：首行距离逐列加一
+        mh <<= 1;
+        pv = (mh | ~(xv | ph)) & mask;
+        mv = ph & xv;
+    }
+    return score;
+}
+
+// 按距离插入结果（距离相同时保留先注册的）
+static int suggest_insert(Suggestion *results, int count, int max_results, const char *name, int distance) {
+    for (int i = 0; i < count; i++) {
+        if (results[i].name == name) {
+            return count; // 已存在
+        }
+    }
+    int pos = count;
+    while (pos > 0 && results[pos - 1].distance > distance) {
+        pos--;
+    }
+    if (pos >= max_results) {
+        return count;
+    }
+    if (count < max_results) {
+        count++;
+    }
+    memmove(&results[pos + 1], &results[pos], (count - pos - 1) * sizeof(Suggestion));
+    results[pos].name = name;
+    results[pos].distance = distance;
+    return count;
+}
+
+// 检查候选项并在足够接近时记录
+static int suggest_consider(SuggestManager *self, int m, const char *candidate,
+                            Suggestion *results, int count, int max_results) {
+    int threshold = suggest_threshold(m);
+    int length = (int)strlen(candidate);
+    // 长度差是编辑距离的下界，先做廉价过滤
+    if (length - m > threshold || m - length > threshold) {
+        return count;
+    }
+    int distance = suggest_distance(self, m, candidate);
+    if (distance > 0 && distance <= threshold) {
+        count = suggest_insert(results, count, max_results, candidate, distance);
+    }
+    return count;
+}
+
+// 查找最接近的命令和别名
+static int suggest_suggest(SuggestManager *self, const char *name, Suggestion *results, int max_results) {
+    int m = (int)strlen(name);
+    if (m == 0 || max_results <= 0) {
+        return 0;
+    }
+    if (m > SUGGEST_MAX_PATTERN) {
+        m = SUGGEST_MAX_PATTERN;
+    }
+
+    // 预处理模式：每个字符对应其出现位置的位掩码
+    for (int i = 0; i < m; i++) {
+        self->peq[(unsigned char)name[i]] |= 1ULL << i;
+    }
+
+    CommandManager *cm = get_command_manager();
+    int count = 0;
+    for (int i = 0; i < cm->get_command_count(cm); i++) {
+        count = suggest_consider(self, m, cm->get_command_name(cm, i), results, count, max_results);
+    }
+    for (int i = 0; i < cm->get_alias_count(cm); i++) {
+        count = suggest_consider(self, m, cm->get_alias(cm, i)->alias, results, count, max_results);
+    }
+
+    // 只清除用到的掩码，避免每次清空整张表
+    for (int i = 0; i < m; i++) {
+        self->peq[(unsigned char)name[i]] = 0;
+    }
+    return count;
+}
+
+// 生成提示文本
+static int suggest_format(SuggestManager *self, const char *name, char *buffer, size_t size) {
+    Suggestion results[SUGGEST_MAX_RESULTS];
+    int count = suggest_suggest(self, name, results, SUGGEST_MAX_RESULTS);
+    if (count == 0 || size == 0) {
+        return 0;
+    }
+
+    size_t used = snprintf(buffer, size, "Did you mean:");
+    for (int i = 0; i < count && used < size; i++) {
+        used += snprintf(buffer + used, size - used, "%s %s", i > 0 ? "," : "", results[i].name);
+    }
+    if (used < size) {
+        snprintf(buffer + used, size - used, "?");
+    }
+    return count;
+}
+
+// 获取单例拼写建议管理器的指针
+SuggestManager* get_suggest_manager() {
+    suggest_manager.suggest = suggest_suggest;
+    suggest_manager.format = suggest_format;
+    return &suggest_manager;
+}
+
+#endif // SHELL_FEATURE_SUGGEST
@@ -0,0 +1,216 @@
+#include "shell_config.h"
+
+#if SHELL_FEATURE_WATCH
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include "watch.h"
+#include "output.h"
+#include "script.h"
+#include "command.h"
+#include "pal.h"
+#include "log.h"
+
+// watch 状态（屏幕缓冲较大，静态分配）
+static WatchState watch_state;
+
+// 重置一屏内容
+static void frame_reset(WatchFrame *frame) {
+    frame->line_count = 1;
+    frame->column = 0;
+    frame->escape = 0;
+    frame->lines[0][0] = '\0';
+}
+
+// 向当前屏追加一个字符，丢弃 ANSI 控制序列，超出宽度或行数的部分截断
+static void frame_put(WatchFrame *frame, char ch) {
+    if (frame->escape == 1) {
+        frame->escape = ch == '[' ? 2 : 0;
+        return;
+    }
+    if (frame->escape == 2) {
+        if (ch >= '@' && ch <= '~') {
+            frame->escape = 0; // 控制序列结束
+        }
+        return;
+    }
+
+    char *line = frame->lines[frame->line_count - 1];
+    if (ch == '\033') {
+        frame->escape = 1;
+    } else if (ch == '\n') {
+        if (frame->line_count < WATCH_MAX_LINES) {
+            frame->lines[frame->line_count++][0] = '\0';
+        }
+        frame->column = 0;
+    } else if (ch == '\r') {
+        frame->column = 0;
+    } else if (ch == '\t') {
+        do {
+            frame_put(frame, ' ');
+        } while (frame->column % 8 != 0 && frame->column < WATCH_LINE_WIDTH);
+    } else if ((unsigned char)ch >= ' ' && frame->column < WATCH_LINE_WIDTH) {
+        size_t length = strlen(line);
+        while ((int)length < frame->column) {
+            line[length++] = ' ';
+        }
+        line[frame->column++] = ch;
+        if ((int)length < frame->column) {
+            line[frame->column] = '\0';
+        }
+    }
+}
+
+// 输出捕获回调：命令输出和日志写入当前屏
+static void watch_capture(void *context, OutputPriority priority, const char *data, size_t length) {
+    WatchFrame *frame = (WatchFrame *)context;
+    for (size_t i = 0; i < length; i++) {
+        frame_put(frame, data[i]);
+    }
+}
+
+// 发送并统计字节数
+static void watch_send(const char *str) {
+    watch_state.bytes_sent += strlen(str);
+    get_pal_interface()->uart_send(str);
+}
+
+// 增量重绘：只发送每行中变化的区间
+static void watch_render(WatchState *state, bool full) {
+    char move[32];
+    int rows = state->current.line_count > state->previous.line_count ?
+               state->current.line_count : state->previous.line_count;
+
+    for (int row = 0; row < rows; row++) {
+        const char *now = row < state->current.line_count ? state->current.lines[row] : "";
+        const char *old = (!full && row < state->previous.line_count) ? state->previous.lines[row] : "";
+        size_t now_length = strlen(now);
+        size_t old_length = full ? (size_t)-1 : strlen(old);
+        state->bytes_full += now_length + 8;
+
+        // 找出第一个和最后一个不同的列
+        size_t first = 0;
+        while (first < now_length && now[first] == old[first]) {
+            first++;
+        }
+        if (!full && first == now_length && now_length == old_length) {
+            continue; // 本行没有变化
+        }
+        size_t last = now_length;
+        if (!full && now_length == old_length) {
+            while (last > first && now[last - 1] == old[last - 1]) {
+                last--;
+            }
+        }
+
+        snprintf(move, sizeof(move), "\033[%d;%dH", WATCH_FIRST_ROW + row, (int)first + 1);
+        watch_send(move);
+        char piece[WATCH_LINE_WIDTH + 1];
+        memcpy(piece, now + first, last - first);
+        piece[last - first] = '\0';
+        watch_send(piece);
+        if (full || now_length < old_length) {
+            watch_send("\033[K"); // 清除行尾残留
+        }
+    }
+}
+
+// watch 命令的参数模式
+static const CommandArg watch_args[] = {
+    COMMAND_ARG_INT("-n", WatchArgs, interval, 1, WATCH_MAX_INTERVAL, WATCH_DEFAULT_INTERVAL),
+    COMMAND_ARG_REST(WatchArgs, command, "command"),
+};
+const CommandSchema watch_schema = COMMAND_SCHEMA(watch_args, WatchArgs, 0);
+
+// watch 命令实现：参数已按 watch_schema 解析和校验
+void watch_command(const void *args) {
+    const WatchArgs *options = (const WatchArgs *)args;
+    LogManager *log_manager = get_log_manager();
+    PalInterface *pal = get_pal_interface();
+    OutputManager *output = get_output_manager();
+#if SHELL_FEATURE_SCRIPT
+    ScriptManager *script = get_script_manager();
+#else
+    CommandManager *commands = get_command_manager();
+#endif
+    WatchState *state = &watch_state;
+
+    // 屏幕缓冲和捕获状态只有一份，不支持嵌套（如 watch ps -w）
+    static bool active = false;
+    if (active) {
+        log_manager->log(LOG_LEVEL_ERROR, "watch: cannot be nested.");
+        return;
+    }
+    if (!output->claim_input(output)) {
+        log_manager->log(LOG_LEVEL_ERROR, "watch: needs console input to quit.");
+        return;
+    }
+    int interval = options->interval < WATCH_MIN_INTERVAL ? WATCH_MIN_INTERVAL : options->interval;
+
+    // 拼接要执行的命令
+    char command[SCRIPT_ARG_BUFFER_SIZE] = "";
+    size_t used = 0;
+    for (int i = 0; i < options->command.argc && used < sizeof(command); i++) {
+        used += snprintf(command + used, sizeof(command) - used, "%s%s", i > 0 ? " " : "", options->command.argv[i]);
+    }
+
+    char header[SCRIPT_ARG_BUFFER_SIZE + 64];
+    snprintf(header, sizeof(header), "\033[2J\033[HEvery %dms: %s  (press 'q' to quit)", interval, command);
+    output->flush(output);
+    state->refreshes = 0;
+    state->bytes_sent = 0;
+    state->bytes_full = 0;
+    watch_send(header);
+
+    // 外层可能已设置捕获（如经 RPC 调用），退出时恢复
+    OutputCaptureFunction saved_capture = output->capture;
+    void *saved_context = output->capture_context;
+    active = true;
+
+    bool quit = false;
+    while (!quit) {
+        frame_reset(&state->current);
+        output->set_capture(output, watch_capture, &state->current);
+#if SHELL_FEATURE_SCRIPT
+        script->run(script, command);
+#else
+        commands->execute_command(commands, command);
+#endif
+        output->set_capture(output, saved_capture, saved_context);
+
+        // 输出以换行结尾时不计最后的空行
+        if (state->current.line_count > 1 && state->current.lines[state->current.line_count - 1][0] == '\0') {
+            state->current.line_count--;
+        }
+        watch_render(state, state->refreshes == 0);
+        state->previous = state->current;
+        state->refreshes++;
+
+        // 等待下一次刷新，期间检查退出键
+        for (int waited = 0; waited < interval && !quit; waited += WATCH_POLL_SLICE) {
+            while (pal->is_key_pressed()) {
+                int ch = output->read_char(output);
+                if (ch == 'q' || ch == 'Q' || ch < 0) {
+                    quit = true;
+                    break;
+                }
+            }
+            if (!quit) {
+                pal->delay(WATCH_POLL_SLICE);
+            }
+        }
+    }
+
+    active = false;
+
+    // 光标移到输出下方，并报告增量重绘节省的带宽
+    char summary[128];
+    snprintf(summary, sizeof(summary), "\033[%d;1H\n", WATCH_FIRST_ROW + state->previous.line_count);
+    pal->uart_send(summary);
+    snprintf(summary, sizeof(summary), "watch: %lu refresh(es), %lu bytes sent, %lu bytes for full redraws.",
+             state->refreshes, state->bytes_sent, state->bytes_full);
+    log_manager->log(LOG_LEVEL_INFO, summary);
+}
+
+#endif // SHELL_FEATURE_WATCH